@@ -0,0 +1,105 @@
+// 方块存储基准：对比原始平铺数组与调色板压缩存储的内存占用与访问开销
+// 不依赖 OpenGL，可在无窗口环境运行
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <vector>
+#include "World/BlockStorage.hpp"
+#include "Math/PerlinNoise.hpp"
+
+constexpr int CHUNK_W = 32;
+constexpr int CHUNK_H = 64;
+constexpr int WATER_LEVEL = 20;
+constexpr int VOLUME = CHUNK_W * CHUNK_H * CHUNK_W;
+
+static int index(int x, int y, int z) { return (x * CHUNK_H + y) * CHUNK_W + z; }
+
+// 与 Chunk::generateTerrain 相同的地形规则
+static void generate(std::vector<BlockType>& out, int cx, int cz, const PerlinNoise& noise) {
+    for (int x = 0; x < CHUNK_W; ++x) {
+        for (int z = 0; z < CHUNK_W; ++z) {
+            double n = noise.fbm((cx * CHUNK_W + x) * 0.04, 0.0, (cz * CHUNK_W + z) * 0.04, 4, 0.5, 2.0);
+            int h = 15 + int((n + 0.5) * 25);
+            if (h >= CHUNK_H) h = CHUNK_H - 1;
+            if (h < 1) h = 1;
+            for (int y = 0; y < CHUNK_H; ++y) {
+                BlockType& b = out[index(x, y, z)];
+                if (y > h) b = (y <= WATER_LEVEL) ? WATER : AIR;
+                else if (y == h) b = (y >= WATER_LEVEL) ? GRASS : DIRT;
+                else b = DIRT;
+            }
+        }
+    }
+}
+
+template <typename F>
+static double nsPerOp(long long ops, F&& body) {
+    auto t0 = std::chrono::steady_clock::now();
+    body();
+    auto t1 = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::nano>(t1 - t0).count() / (double)ops;
+}
+
+int main() {
+    PerlinNoise noise(123);
+    const int viewDist = 6;
+    std::vector<std::vector<BlockType>> flats;
+    std::vector<BlockStorage> packed;
+
+    size_t packedBytes = 0;
+    int histogram[9] = {0};
+    for (int x = -viewDist; x <= viewDist; ++x) {
+        for (int z = -viewDist; z <= viewDist; ++z) {
+            flats.emplace_back(VOLUME);
+            generate(flats.back(), x, z, noise);
+            packed.emplace_back(VOLUME);
+            packed.back().pack(flats.back().data());
+            packedBytes += packed.back().memoryUsage();
+            histogram[packed.back().bitsPerBlock()]++;
+        }
+    }
+    const size_t chunkCount = flats.size();
+
+    // 正确性：解包结果必须与原始数据一致
+    std::vector<BlockType> check(VOLUME);
+    for (size_t i = 0; i < chunkCount; ++i) {
+        packed[i].unpack(check.data());
+        if (check != flats[i]) { std::printf("unpack mismatch in chunk %zu\n", i); return 1; }
+    }
+
+    std::printf("chunks: %zu\n", chunkCount);
+    std::printf("bytes/chunk   flat: %8zu   palette: %8zu\n", (size_t)VOLUME, packedBytes / chunkCount);
+    std::printf("bits/block distribution: 0:%d 1:%d 2:%d 4:%d 8:%d\n",
+                histogram[0], histogram[1], histogram[2], histogram[4], histogram[8]);
+
+    // 随机访问：同一组下标分别读两种布局
+    const int N = 1 << 22;
+    std::mt19937 rng(7);
+    std::vector<int> chunkIdx(N), cellIdx(N);
+    for (int i = 0; i < N; ++i) {
+        chunkIdx[i] = (int)(rng() % chunkCount);
+        cellIdx[i] = (int)(rng() % VOLUME);
+    }
+    unsigned sink = 0;
+    double flatRandom = nsPerOp(N, [&] { for (int i = 0; i < N; ++i) sink += flats[chunkIdx[i]][cellIdx[i]]; });
+    double packRandom = nsPerOp(N, [&] { for (int i = 0; i < N; ++i) sink += packed[chunkIdx[i]].get(cellIdx[i]); });
+
+    // 顺序访问：按 [x][y][z] 遍历整个区块
+    long long seqOps = (long long)chunkCount * VOLUME;
+    double flatSeq = nsPerOp(seqOps, [&] { for (auto& c : flats) for (int i = 0; i < VOLUME; ++i) sink += c[i]; });
+    double packSeq = nsPerOp(seqOps, [&] { for (auto& c : packed) for (int i = 0; i < VOLUME; ++i) sink += c.get(i); });
+
+    // 随机写入 (模拟玩家编辑)
+    double flatSet = nsPerOp(N, [&] { for (int i = 0; i < N; ++i) flats[chunkIdx[i]][cellIdx[i]] = STONE; });
+    double packSet = nsPerOp(N, [&] { for (int i = 0; i < N; ++i) packed[chunkIdx[i]].set(cellIdx[i], STONE); });
+
+    // 网格构建前的整块解包
+    std::vector<BlockType> scratch(VOLUME);
+    double unpackNs = nsPerOp((long long)chunkCount, [&] { for (auto& c : packed) { c.unpack(scratch.data()); sink += scratch[0]; } });
+
+    std::printf("random get    flat: %8.2f ns  palette: %8.2f ns\n", flatRandom, packRandom);
+    std::printf("seq get       flat: %8.2f ns  palette: %8.2f ns\n", flatSeq, packSeq);
+    std::printf("random set    flat: %8.2f ns  palette: %8.2f ns\n", flatSet, packSet);
+    std::printf("unpack chunk  %.1f us\n", unpackNs / 1000.0);
+    return sink == 0xFFFFFFFF ? 1 : 0;
+}
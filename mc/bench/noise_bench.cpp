@@ -0,0 +1,65 @@
+// 噪声基准：逐列调用 fbm 与批量 fbmGrid 生成区块高度图的吞吐对比，并校验两者误差
+// 不依赖 OpenGL，可在无窗口环境运行
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <vector>
+#include "Math/PerlinNoise.hpp"
+
+constexpr int CHUNK_W = 32;
+constexpr int GRID = 32;            // 32x32 个区块
+constexpr double SCALE = 0.04;      // 与 Chunk::generateTerrain 一致
+constexpr float TOLERANCE = 1e-4f;
+
+using Clock = std::chrono::steady_clock;
+
+static double seconds(Clock::time_point a, Clock::time_point b) {
+    return std::chrono::duration<double>(b - a).count();
+}
+
+int main() {
+    PerlinNoise noise(12345);
+    const int columns = GRID * GRID * CHUNK_W * CHUNK_W;
+    std::vector<float> scalar(CHUNK_W * CHUNK_W), batch(CHUNK_W * CHUNK_W);
+    double sink = 0.0;
+
+    // 逐列 fbm (double)
+    auto t0 = Clock::now();
+    for (int cx = 0; cx < GRID; ++cx)
+        for (int cz = 0; cz < GRID; ++cz)
+            for (int z = 0; z < CHUNK_W; ++z)
+                for (int x = 0; x < CHUNK_W; ++x)
+                    sink += noise.fbm((cx * CHUNK_W + x) * SCALE, 0.0, (cz * CHUNK_W + z) * SCALE, 4, 0.5, 2.0);
+    auto t1 = Clock::now();
+
+    // 批量 fbmGrid
+    for (int cx = 0; cx < GRID; ++cx)
+        for (int cz = 0; cz < GRID; ++cz) {
+            noise.fbmGrid(batch.data(), CHUNK_W, CHUNK_W, CHUNK_W,
+                          cx * CHUNK_W * SCALE, cz * CHUNK_W * SCALE, SCALE, SCALE, 0.0, 4, 0.5, 2.0);
+            sink += batch[0];
+        }
+    auto t2 = Clock::now();
+
+    // 误差校验 (包含远离原点的大坐标)
+    float maxErr = 0.0f;
+    const int origins[][2] = {{0, 0}, {-3, 7}, {1000, -1000}, {-40000, 25000}};
+    for (auto& o : origins) {
+        double x0 = o[0] * CHUNK_W * SCALE, z0 = o[1] * CHUNK_W * SCALE;
+        noise.fbmGrid(batch.data(), CHUNK_W, CHUNK_W, CHUNK_W, x0, z0, SCALE, SCALE, 0.0, 4, 0.5, 2.0);
+        for (int z = 0; z < CHUNK_W; ++z)
+            for (int x = 0; x < CHUNK_W; ++x) {
+                float ref = (float)noise.fbm(x0 + x * SCALE, 0.0, z0 + z * SCALE, 4, 0.5, 2.0);
+                maxErr = std::fmax(maxErr, std::fabs(ref - batch[z * CHUNK_W + x]));
+            }
+    }
+
+    double fbmTime = seconds(t0, t1), batchTime = seconds(t1, t2);
+    std::printf("backend           : %s\n", PerlinNoise::batchBackend());
+    std::printf("fbm (per column)  : %8.2f ms  %8.2f Mcolumns/s\n", fbmTime * 1e3, columns / fbmTime / 1e6);
+    std::printf("fbmGrid (batched) : %8.2f ms  %8.2f Mcolumns/s  (x%.2f)\n",
+                batchTime * 1e3, columns / batchTime / 1e6, fbmTime / batchTime);
+    std::printf("max abs error     : %.2e (tolerance %.0e)\n", maxErr, TOLERANCE);
+    std::printf("(checksum %.3f)\n", sink);
+    return maxErr <= TOLERANCE ? 0 : 1;
+}
@@ -0,0 +1,446 @@
+// 世界核心路径基准：地形生成、贪婪网格、World::getBlock、DDA 射线、玩家碰撞、方块编辑与洞穴剔除
+// 只链接 MyCraftCore，不创建窗口 / OpenGL 上下文
+// 用法: WorldBench [结果文件.json]   (默认 world_bench.json)
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+#include "World/World.hpp"
+#include "Math/Raycast.hpp"
+#include "Physics/Player.hpp"
+#include "World/CaveCuller.hpp"
+#include <glm/gtc/matrix_transform.hpp>
+
+using Clock = std::chrono::steady_clock;
+
+constexpr int GRID = 8;       // 基准世界为 GRID x GRID 个区块
+constexpr int REPEATS = 3;    // 每项取最快的一次，减少抖动
+
+struct Result {
+    std::string name;
+    std::string unit;     // 吞吐单位
+    double seconds;       // 单次耗时
+    double operations;    // 单次处理的数量 (区块 / 三角形 / 查询 / 射线)
+};
+
+// 运行 REPEATS 次取最短耗时
+template <typename Fn>
+static double timeBest(Fn&& fn) {
+    double best = 1e30;
+    for (int r = 0; r < REPEATS; ++r) {
+        auto t0 = Clock::now();
+        fn();
+        double s = std::chrono::duration<double>(Clock::now() - t0).count();
+        if (s < best) best = s;
+    }
+    return best;
+}
+
+// 附加统计 (非耗时类指标，如剔除后的平均区块数)
+using Stats = std::vector<std::pair<std::string, double>>;
+
+static void writeJson(const std::string& path, const std::vector<Result>& results, const Stats& stats) {
+    std::ofstream f(path);
+    f << "{\n  \"noise_backend\": \"" << PerlinNoise::batchBackend() << "\",\n"
+      << "  \"chunk\": [" << CHUNK_W << ", " << CHUNK_H << ", " << CHUNK_W << "],\n"
+      << "  \"grid\": " << GRID << ",\n  \"results\": [\n";
+    for (size_t i = 0; i < results.size(); ++i) {
+        const Result& r = results[i];
+        char line[256];
+        std::snprintf(line, sizeof(line),
+                      "    {\"name\": \"%s\", \"seconds\": %.6f, \"operations\": %.0f, \"unit\": \"%s\", \"per_second\": %.1f}%s\n",
+                      r.name.c_str(), r.seconds, r.operations, r.unit.c_str(), r.operations / r.seconds,
+                      i + 1 < results.size() ? "," : "");
+        f << line;
+    }
+    f << "  ],\n  \"stats\": {";
+    for (size_t i = 0; i < stats.size(); ++i)
+        f << (i ? ", " : "") << "\"" << stats[i].first << "\": " << stats[i].second;
+    f << "}\n}\n";
+}
+
+int main(int argc, char** argv) {
+    std::string outPath = argc > 1 ? argv[1] : "world_bench.json";
+    PerlinNoise noise(12345);
+    std::vector<Result> results;
+    Stats stats;
+    long long sink = 0; // 累加各项结果并最终输出，防止被优化掉
+
+    // 1. 地形生成 (噪声 + 调色板打包)
+    {
+        double s = timeBest([&] {
+            for (int cx = 0; cx < GRID; ++cx)
+                for (int cz = 0; cz < GRID; ++cz) {
+                    Chunk c(cx, cz, noise);
+                    sink += (long long)c.blocks.memoryUsage();
+                }
+        });
+        results.push_back({"terrain_generation", "chunks", s, double(GRID * GRID)});
+    }
+
+    World world(noise);
+    world.setLodDistance(0); // 基准测试的区块都按原始精度构建网格 (LOD 单独测)
+    for (int cx = 0; cx < GRID; ++cx)
+        for (int cz = 0; cz < GRID; ++cz) world.addChunk(cx, cz);
+
+    // 2. 网格构建 (含 halo 快照)，两种算法分别计时，吞吐按三角形计
+    {
+        ChunkSnapshot snap;
+        ChunkMesh mesh;
+        auto run = [&](MesherType type) {
+            double triangles = 0;
+            double s = timeBest([&] {
+                triangles = 0;
+                for (int cx = 0; cx < GRID; ++cx)
+                    for (int cz = 0; cz < GRID; ++cz) {
+                        world.buildSnapshot(cx, cz, snap);
+                        world.chunks.at({cx, cz})->buildMesh(snap, mesh, type);
+                        triangles += mesh.vertices.size() / 4 * 2;
+                    }
+            });
+            return std::make_pair(s, triangles);
+        };
+        auto greedy = run(MesherType::Greedy);
+        auto binary = run(MesherType::Binary);
+        results.push_back({"greedy_meshing", "triangles", greedy.first, greedy.second});
+        results.push_back({"binary_meshing", "triangles", binary.first, binary.second});
+
+        // 两种算法在每个切面上必须生成相同的四边形集合 (顺序可以不同)
+        auto quads = [](const ChunkMesh& m, int slice) {
+            std::vector<std::array<uint64_t, 4>> q(m.sliceSize(slice) / 4);
+            const Vertex* v = m.vertices.data() + m.sliceOffsets[slice];
+            for (size_t i = 0; i < q.size(); ++i)
+                for (int k = 0; k < 4; ++k) q[i][k] = (uint64_t)v[i * 4 + k].data0 << 32 | v[i * 4 + k].data1;
+            std::sort(q.begin(), q.end());
+            return q;
+        };
+        ChunkMesh other;
+        for (int cx = 0; cx < GRID; ++cx)
+            for (int cz = 0; cz < GRID; ++cz) {
+                world.buildSnapshot(cx, cz, snap);
+                const Chunk& chunk = *world.chunks.at({cx, cz});
+                chunk.buildMesh(snap, mesh, MesherType::Greedy);
+                chunk.buildMesh(snap, other, MesherType::Binary);
+                for (int s = 0; s < MESH_SLICE_COUNT; ++s) {
+                    if (quads(mesh, s) != quads(other, s)) {
+                        std::fprintf(stderr, "mesher mismatch in chunk (%d, %d) slice %d\n", cx, cz, s);
+                        return 1;
+                    }
+                }
+            }
+    }
+
+    const int worldW = GRID * CHUNK_W;
+
+    // 3. World::getBlock 顺序访问 (按区块存储顺序遍历)
+    {
+        double s = timeBest([&] {
+            long long solid = 0;
+            for (int cx = 0; cx < GRID; ++cx)
+                for (int cz = 0; cz < GRID; ++cz)
+                    for (int x = 0; x < CHUNK_W; ++x)
+                        for (int y = 0; y < CHUNK_H; ++y)
+                            for (int z = 0; z < CHUNK_W; ++z)
+                                solid += world.getBlock(cx * CHUNK_W + x, y, cz * CHUNK_W + z) != AIR;
+            sink += solid;
+        });
+        results.push_back({"get_block_sequential", "queries", s, double(GRID * GRID) * CHUNK_VOLUME});
+    }
+
+    // 4. World::getBlock 随机访问 (坐标预先生成，不计入随机数开销)
+    {
+        const int count = 4'000'000;
+        std::mt19937 rng(7);
+        std::vector<glm::ivec3> coords(count);
+        for (auto& c : coords)
+            c = {int(rng() % worldW), int(rng() % CHUNK_H), int(rng() % worldW)};
+        double s = timeBest([&] {
+            long long solid = 0;
+            for (const auto& c : coords) solid += world.getBlock(c.x, c.y, c.z) != AIR;
+            sink += solid;
+        });
+        results.push_back({"get_block_random", "queries", s, double(count)});
+    }
+
+    // 5. DDA 射线：从地表上方随机点射向随机的斜下方
+    {
+        const int count = 200'000;
+        std::mt19937 rng(11);
+        std::uniform_real_distribution<float> pos(CHUNK_W, float(worldW - CHUNK_W));
+        std::uniform_real_distribution<float> dir(-1.0f, 1.0f);
+        std::vector<std::pair<glm::vec3, glm::vec3>> rays(count);
+        for (auto& r : rays) {
+            glm::vec3 d(dir(rng), -0.2f - std::fabs(dir(rng)), dir(rng));
+            r = {glm::vec3(pos(rng), CHUNK_H - 2.0f, pos(rng)), glm::normalize(d)};
+        }
+        double s = timeBest([&] {
+            long long hits = 0;
+            for (const auto& r : rays) hits += Raycaster::Cast(world, r.first, r.second, 64.0f).hit;
+            sink += hits;
+        });
+        results.push_back({"raycast_dda", "rays", s, double(count)});
+    }
+
+    // 6. 玩家碰撞箱检测 (随机位置，覆盖地表附近)
+    {
+        const int count = 1'000'000;
+        std::mt19937 rng(13);
+        std::uniform_real_distribution<float> xz(1.0f, float(worldW - 1));
+        std::uniform_real_distribution<float> y(10.0f, 45.0f);
+        std::vector<glm::vec3> positions(count);
+        for (auto& p : positions) p = {xz(rng), y(rng), xz(rng)};
+        Player player(glm::vec3(0.0f));
+        double s = timeBest([&] {
+            long long colliding = 0;
+            for (const auto& p : positions) colliding += player.checkCollision(p, world);
+            sink += colliding;
+        });
+        results.push_back({"player_collision", "checks", s, double(count)});
+    }
+
+    // 7. 单方块编辑：setBlock + 本帧处理 (只重建受影响的切面)，与整块重建对比
+    {
+        world.processDirtyChunks();
+        while (world.pendingMeshJobs() > 0) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        for (auto& pair : world.chunks) pair.second->slicePatches.clear();
+
+        const int count = 20'000;
+        std::mt19937 rng(17);
+        std::vector<std::pair<glm::ivec3, BlockType>> edits(count);
+        for (auto& e : edits)
+            e = {{int(rng() % worldW), int(rng() % CHUNK_H), int(rng() % worldW)}, (BlockType)(rng() % 6)};
+        double s = timeBest([&] {
+            for (const auto& e : edits) {
+                world.setBlock(e.first.x, e.first.y, e.first.z, e.second);
+                world.processDirtyChunks();
+            }
+            for (auto& pair : world.chunks) pair.second->slicePatches.clear();
+        });
+        results.push_back({"block_edit_incremental", "edits", s, double(count)});
+
+        // 对照：每次编辑都整块重建 (快照 + 位掩码网格)
+        ChunkSnapshot snap;
+        ChunkMesh mesh;
+        const int fullCount = 500;
+        double full = timeBest([&] {
+            for (int i = 0; i < fullCount; ++i) {
+                const auto& e = edits[i];
+                int cx = e.first.x / CHUNK_W, cz = e.first.z / CHUNK_W;
+                world.buildSnapshot(cx, cz, snap);
+                world.chunks.at({cx, cz})->buildMesh(snap, mesh, MesherType::Binary);
+            }
+        });
+        results.push_back({"block_edit_full_rebuild", "edits", full, double(fullCount)});
+    }
+
+    // 8. 洞穴剔除：地表与地下的随机相机，统计通过视锥的区块数与遍历可达的区块数
+    {
+        // 没有渲染器取走网格，这里直接在主线程算好各段连通性
+        for (auto& pair : world.chunks)
+            for (int s = 0; s < SECTION_COUNT; ++s) pair.second->setVisibility(s, pair.second->computeVisibility(s));
+
+        const int count = 2'000;
+        const float farPlane = (world.getRenderDistance() + 2) * (float)CHUNK_W;
+        glm::mat4 proj = glm::perspective(glm::radians(60.0f), 16.0f / 9.0f, 0.1f, farPlane);
+        std::vector<Chunk*> candidates, visible;
+        CaveCuller culler;
+
+        auto run = [&](const char* name, float yMin, float yMax, unsigned seed) {
+            std::mt19937 rng(seed);
+            std::uniform_real_distribution<float> xz(0.0f, float(worldW));
+            std::uniform_real_distribution<float> y(yMin, yMax);
+            std::uniform_real_distribution<float> angle(0.0f, 6.2831853f);
+            std::vector<std::pair<glm::vec3, Frustum>> cameras(count);
+            for (auto& c : cameras) {
+                glm::vec3 pos(xz(rng), y(rng), xz(rng));
+                float yaw = angle(rng);
+                glm::vec3 front(std::cos(yaw), -0.3f, std::sin(yaw));
+                c.first = pos;
+                c.second.update(proj * glm::lookAt(pos, pos + front, glm::vec3(0, 1, 0)));
+            }
+            double frustumTotal = 0, visibleTotal = 0;
+            double s = timeBest([&] {
+                frustumTotal = visibleTotal = 0;
+                for (const auto& c : cameras) {
+                    candidates.clear();
+                    for (auto& pair : world.chunks)
+                        if (c.second.isBoxVisible(pair.second->aabb)) candidates.push_back(pair.second.get());
+                    culler.cull(world, c.first, c.second, candidates, visible);
+                    frustumTotal += culler.frustumChunks;
+                    visibleTotal += culler.visibleChunks;
+                }
+            });
+            results.push_back({name, "culls", s, double(count)});
+            stats.push_back({std::string(name) + "_frustum_chunks", frustumTotal / count});
+            stats.push_back({std::string(name) + "_visible_chunks", visibleTotal / count});
+        };
+        run("cave_culling_surface", 45.0f, 60.0f, 19);
+        run("cave_culling_underground", 2.0f, 12.0f, 23);
+    }
+
+    // 9. 远处区块降采样：每个细节级别 (0 为原始精度) 对全部区块重建网格，统计每区块三角形数
+    {
+        ChunkSnapshot snap;
+        ChunkMesh mesh;
+        for (int lod = 0; lod <= World::MAX_LOD; ++lod) {
+            for (auto& pair : world.chunks) pair.second->lod = lod;
+            double triangles = 0;
+            double s = timeBest([&] {
+                triangles = 0;
+                for (auto& pair : world.chunks) {
+                    world.buildSnapshot(pair.first.x, pair.first.z, snap);
+                    snap.applyLod();
+                    pair.second->buildMesh(snap, mesh, MesherType::Binary);
+                    triangles += mesh.vertices.size() / 4 * 2;
+                }
+            });
+            std::string name = "lod" + std::to_string(lod) + "_meshing";
+            results.push_back({name, "chunks", s, double(world.chunks.size())});
+            stats.push_back({name + "_triangles_per_chunk", triangles / world.chunks.size()});
+        }
+        for (auto& pair : world.chunks) pair.second->lod = 0;
+    }
+
+    // 10. 视锥剔除：渲染距离 32 (含卸载余量) 的全部区块，逐个标量测试 vs 分组 + 批量测试，两者结果必须相同
+    {
+        const int r = 32 + 2;
+        std::unordered_map<ChunkCoord, std::unique_ptr<Chunk>, ChunkHash> chunks;
+        ChunkBoundsIndex index;
+        for (int cx = -r; cx <= r; ++cx)
+            for (int cz = -r; cz <= r; ++cz) {
+                if (cx * cx + cz * cz > r * r) continue;
+                auto chunk = std::make_unique<Chunk>(cx, cz); // 只用到包围盒，不生成地形
+                index.insert(chunk.get(), cx, cz);
+                chunks[{cx, cz}] = std::move(chunk);
+            }
+
+        const int count = 2'000;
+        const float farPlane = (r + 2) * (float)CHUNK_W;
+        glm::mat4 proj = glm::perspective(glm::radians(60.0f), 16.0f / 9.0f, 0.1f, farPlane);
+        std::mt19937 rng(29);
+        std::uniform_real_distribution<float> xz(-2.0f * CHUNK_W, 2.0f * CHUNK_W);
+        std::uniform_real_distribution<float> angle(0.0f, 6.2831853f);
+        std::uniform_real_distribution<float> pitch(-0.8f, 0.3f);
+        std::vector<Frustum> frusta(count);
+        for (Frustum& f : frusta) {
+            glm::vec3 pos(xz(rng), 50.0f, xz(rng));
+            float yaw = angle(rng), p = pitch(rng);
+            glm::vec3 front(std::cos(yaw) * std::cos(p), std::sin(p), std::sin(yaw) * std::cos(p));
+            f.update(proj * glm::lookAt(pos, pos + front, glm::vec3(0, 1, 0)));
+        }
+
+        std::vector<Chunk*> scalarOut, indexOut;
+        double visible = 0;
+        double scalar = timeBest([&] {
+            visible = 0;
+            for (const Frustum& f : frusta) {
+                scalarOut.clear();
+                for (auto& pair : chunks)
+                    if (f.isBoxVisible(pair.second->aabb)) scalarOut.push_back(pair.second.get());
+                visible += scalarOut.size();
+            }
+        });
+        double rejected = 0, accepted = 0, tested = 0;
+        double grouped = timeBest([&] {
+            rejected = accepted = tested = 0;
+            for (const Frustum& f : frusta) {
+                indexOut.clear();
+                index.cull(f, indexOut);
+                rejected += index.groupsRejected;
+                accepted += index.groupsAccepted;
+                tested += index.groupsTested;
+                sink += (long long)indexOut.size();
+            }
+        });
+        for (const Frustum& f : frusta) {
+            scalarOut.clear();
+            indexOut.clear();
+            for (auto& pair : chunks)
+                if (f.isBoxVisible(pair.second->aabb)) scalarOut.push_back(pair.second.get());
+            index.cull(f, indexOut);
+            std::sort(scalarOut.begin(), scalarOut.end());
+            std::sort(indexOut.begin(), indexOut.end());
+            if (scalarOut != indexOut) {
+                std::fprintf(stderr, "frustum culling mismatch (%zu vs %zu chunks)\n", scalarOut.size(), indexOut.size());
+                return 1;
+            }
+        }
+        results.push_back({"frustum_culling_scalar", "culls", scalar, double(count)});
+        results.push_back({"frustum_culling_grouped", "culls", grouped, double(count)});
+        stats.push_back({"frustum_culling_chunks", double(chunks.size())});
+        stats.push_back({"frustum_culling_visible_chunks", visible / count});
+        stats.push_back({"frustum_culling_groups_rejected", rejected / count});
+        stats.push_back({"frustum_culling_groups_accepted", accepted / count});
+        stats.push_back({"frustum_culling_groups_tested", tested / count});
+    }
+
+    // 11. 启动：渲染距离 8，从空世界到玩家周围 (半径 1) / 整个加载范围都建好网格的时间
+    //     同步 = 原来的做法，每帧在主线程生成 4 个区块；流水线 = updateStreaming 交给后台线程由近到远加载
+    {
+        const int dist = 8;
+        const glm::vec3 spawn(16.0f, 40.0f, 16.0f);
+        // worstMs：主线程单次迭代 (相当于一帧里的加载 + 网格调度) 的最长耗时
+        auto measure = [&](bool pipeline, double& firstMs, double& fullMs, double& worstMs) {
+            World w(noise);
+            w.setRenderDistance(dist);
+            ChunkMesh uploaded;
+            std::vector<ChunkCoord> order;
+            for (int dx = -dist; dx <= dist; ++dx)
+                for (int dz = -dist; dz <= dist; ++dz)
+                    if (dx * dx + dz * dz <= dist * dist) order.push_back({dx, dz});
+            std::sort(order.begin(), order.end(), [](const ChunkCoord& a, const ChunkCoord& b) {
+                return a.x * a.x + a.z * a.z < b.x * b.x + b.z * b.z;
+            });
+            size_t next = 0;
+            firstMs = -1;
+            worstMs = 0;
+            auto t0 = std::chrono::steady_clock::now();
+            while (true) {
+                auto step = std::chrono::steady_clock::now();
+                if (pipeline) {
+                    w.updateStreaming(spawn);
+                } else {
+                    for (int i = 0; i < 4 && next < order.size(); ++i, ++next) w.addChunk(order[next].x, order[next].z);
+                }
+                w.processDirtyChunks();
+                // 没有渲染器：取走网格即视为已上传 (不限预算)
+                for (auto& pair : w.chunks) {
+                    if (pair.second->takeMesh(uploaded)) pair.second->meshUploaded = true;
+                }
+                auto now = std::chrono::steady_clock::now();
+                worstMs = std::max(worstMs, std::chrono::duration<double, std::milli>(now - step).count());
+                double ms = std::chrono::duration<double, std::milli>(now - t0).count();
+                if (firstMs < 0 && w.isAreaReady(spawn, 1)) firstMs = ms;
+                if (w.isAreaReady(spawn, dist)) { fullMs = ms; break; }
+                std::this_thread::yield();
+            }
+        };
+        for (bool pipeline : {false, true}) {
+            double first = 1e30, full = 1e30, worst = 1e30;
+            for (int rep = 0; rep < 3; ++rep) {
+                double f, u, m;
+                measure(pipeline, f, u, m);
+                first = std::min(first, f);
+                full = std::min(full, u);
+                worst = std::min(worst, m);
+            }
+            std::string name = pipeline ? "startup_pipeline" : "startup_sync";
+            stats.push_back({name + "_first_frame_ms", first});
+            stats.push_back({name + "_full_view_ms", full});
+            stats.push_back({name + "_worst_main_step_ms", worst});
+        }
+    }
+
+    for (const Result& r : results)
+        std::printf("%-24s %9.2f ms  %14.0f %s/s\n", r.name.c_str(), r.seconds * 1e3, r.operations / r.seconds, r.unit.c_str());
+    for (const auto& st : stats)
+        std::printf("%-40s %9.1f\n", st.first.c_str(), st.second);
+    writeJson(outPath, results, stats);
+    std::printf("results written to %s (checksum %lld)\n", outPath.c_str(), sink);
+    return 0;
+}
@@ -0,0 +1,350 @@
+// 无窗口的长时间运行测试：Player 沿脚本 / 录制的路径飞行，按固定频率编辑方块，
+// 每帧走一遍主循环中与 OpenGL 无关的部分 (流式加载、网格调度、视锥剔除)，上传改为只取走网格并计数
+// 定期输出帧预算超标次数、各队列深度、内存占用 (RSS / 峰值) 与区块吞吐，用来在发布前发现泄漏与卡顿
+// --fast 不等待帧间隙，后台线程少于主循环需要时队列会持续增长 (核心数少的机器上尤其明显)
+// 用法: WorldSoak [--seconds 300] [--path figure8|line|路径文件] [--speed 30] [--edits 20]
+//                 [--render-distance 8] [--budget-ms 16.7] [--interval 10] [--fast] [--save-dir 目录] [--chunk-pool 128]
+//                 [--out soak.json]
+// 路径文件每行一个路点 "x y z" (# 开头为注释)，游戏中可用 --record-path 录制
+// --chunk-pool N 设置区块回收池上限 (0 关闭)，报告中的 new chunks / heap allocs 用于确认稳定移动时区块存储不再分配
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <new>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "World/World.hpp"
+#include "Physics/Player.hpp"
+#include <glm/gtc/matrix_transform.hpp>
+
+#if defined(_WIN32)
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+
+using Clock = std::chrono::steady_clock;
+
+// 全局堆分配计数 (所有线程)
+static std::atomic<uint64_t> heapAllocations{0};
+
+void* operator new(std::size_t size) {
+    heapAllocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+
+struct Options {
+    double seconds = 300.0;       // 模拟时长
+    std::string path = "figure8";
+    float speed = 30.0f;          // 飞行速度 (格/秒)
+    float editsPerSecond = 20.0f;
+    int renderDistance = 8;
+    double budgetMs = 1000.0 / 60.0;
+    double intervalSeconds = 10.0; // 报告间隔 (模拟时间)
+    bool fast = false;            // 不按 60 FPS 节奏等待，尽快跑完
+    std::string saveDir;          // 非空时开启存档 (同时测试写盘队列)
+    std::string outPath = "world_soak.json";
+    int chunkPool = 128;          // 区块回收池上限
+};
+
+// 当前 / 峰值常驻内存 (MB)
+static void readRss(double& currentMb, double& peakMb) {
+    currentMb = peakMb = 0.0;
+#if defined(_WIN32)
+    PROCESS_MEMORY_COUNTERS pmc;
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &pmc, sizeof(pmc))) {
+        currentMb = pmc.WorkingSetSize / 1048576.0;
+        peakMb = pmc.PeakWorkingSetSize / 1048576.0;
+    }
+#else
+    // Linux 从 /proc 读 (单位 KB)；其他平台只有 getrusage 的峰值 (macOS 单位字节)
+    std::ifstream status("/proc/self/status");
+    std::string line;
+    while (std::getline(status, line)) {
+        if (line.rfind("VmRSS:", 0) == 0) currentMb = std::atof(line.c_str() + 6) / 1024.0;
+        else if (line.rfind("VmHWM:", 0) == 0) peakMb = std::atof(line.c_str() + 6) / 1024.0;
+    }
+    if (peakMb == 0.0) {
+        rusage usage{};
+        getrusage(RUSAGE_SELF, &usage);
+#if defined(__APPLE__)
+        peakMb = usage.ru_maxrss / 1048576.0;
+#else
+        peakMb = usage.ru_maxrss / 1024.0;
+#endif
+    }
+#endif
+}
+
+static std::vector<glm::vec3> makePath(const std::string& name) {
+    std::vector<glm::vec3> points;
+    if (name == "figure8") {
+        // 8 字形，横跨约 1600 格，回到起点后循环
+        for (int i = 0; i < 64; ++i) {
+            float a = i / 64.0f * 6.2831853f;
+            points.emplace_back(800.0f * std::sin(a), 50.0f, 400.0f * std::sin(2.0f * a));
+        }
+    } else if (name == "line") {
+        // 直线飞出 4000 格再飞回 (一直进入新区域，不断生成与卸载)
+        points.emplace_back(0.0f, 50.0f, 0.0f);
+        points.emplace_back(4000.0f, 50.0f, 1000.0f);
+    } else {
+        std::ifstream file(name);
+        std::string line;
+        while (std::getline(file, line)) {
+            if (line.empty() || line[0] == '#') continue;
+            std::istringstream in(line);
+            glm::vec3 p;
+            if (in >> p.x >> p.y >> p.z) points.push_back(p);
+        }
+    }
+    return points;
+}
+
+// 代替 ChunkRenderer::upload：取走网格与切面补丁，CPU 端保留一份顶点 (渲染器的 meshLayout 同样保存一份)，只统计数量
+struct NullUploader {
+    ChunkMesh staging;
+    uint64_t meshes = 0, patches = 0, bytes = 0;
+
+    void upload(Chunk& chunk) {
+        if (chunk.takeMesh(staging)) {
+            chunk.meshLayout.vertices = staging.vertices;
+            chunk.meshUploaded = true;
+            meshes++;
+            bytes += staging.vertices.size() * sizeof(Vertex);
+        }
+        for (const SlicePatch& patch : chunk.slicePatches) {
+            patches++;
+            bytes += patch.vertices.size() * sizeof(Vertex);
+        }
+        chunk.slicePatches.clear();
+    }
+};
+
+// 一个报告间隔的统计
+struct Sample {
+    double time;                 // 模拟时间 (秒)
+    int frames, overBudget;
+    double avgFrameMs, maxFrameMs;
+    size_t chunks;
+    size_t pendingLoads, pendingMeshJobs, dirtyChunks, pendingSaves; // 间隔内每帧采样的最大值
+    double loadedPerSecond, unloadedPerSecond, meshesPerSecond, patchesPerSecond, uploadMbPerSecond;
+    uint64_t edits;
+    uint64_t newChunks;          // 间隔内回收池新分配的区块数
+    size_t pooledChunks;
+    double heapAllocsPerSecond;
+    double rssMb, peakRssMb;
+};
+
+static void writeJson(const std::string& path, const Options& opt, const std::vector<Sample>& samples) {
+    std::ofstream f(path);
+    f << "{\n  \"path\": \"" << opt.path << "\", \"render_distance\": " << opt.renderDistance
+      << ", \"speed\": " << opt.speed << ", \"edits_per_second\": " << opt.editsPerSecond
+      << ", \"budget_ms\": " << opt.budgetMs << ", \"chunk_pool\": " << opt.chunkPool << ",\n  \"samples\": [\n";
+    for (size_t i = 0; i < samples.size(); ++i) {
+        const Sample& s = samples[i];
+        char line[768];
+        std::snprintf(line, sizeof(line),
+                      "    {\"time\": %.1f, \"frames\": %d, \"over_budget\": %d, \"avg_frame_ms\": %.3f, \"max_frame_ms\": %.3f, "
+                      "\"chunks\": %zu, \"pending_loads\": %zu, \"pending_mesh_jobs\": %zu, \"dirty_chunks\": %zu, \"pending_saves\": %zu, "
+                      "\"loaded_per_s\": %.1f, \"unloaded_per_s\": %.1f, \"meshes_per_s\": %.1f, \"patches_per_s\": %.1f, "
+                      "\"upload_mb_per_s\": %.2f, \"edits\": %llu, \"new_chunks\": %llu, \"pooled_chunks\": %zu, "
+                      "\"heap_allocs_per_s\": %.0f, \"rss_mb\": %.1f, \"peak_rss_mb\": %.1f}%s\n",
+                      s.time, s.frames, s.overBudget, s.avgFrameMs, s.maxFrameMs,
+                      s.chunks, s.pendingLoads, s.pendingMeshJobs, s.dirtyChunks, s.pendingSaves,
+                      s.loadedPerSecond, s.unloadedPerSecond, s.meshesPerSecond, s.patchesPerSecond,
+                      s.uploadMbPerSecond, (unsigned long long)s.edits, (unsigned long long)s.newChunks, s.pooledChunks,
+                      s.heapAllocsPerSecond, s.rssMb, s.peakRssMb,
+                      i + 1 < samples.size() ? "," : "");
+        f << line;
+    }
+    f << "  ]\n}\n";
+}
+
+int main(int argc, char** argv) {
+    Options opt;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--fast") { opt.fast = true; continue; }
+        if (i + 1 >= argc) break;
+        if (arg == "--seconds") opt.seconds = std::atof(argv[++i]);
+        else if (arg == "--path") opt.path = argv[++i];
+        else if (arg == "--speed") opt.speed = (float)std::atof(argv[++i]);
+        else if (arg == "--edits") opt.editsPerSecond = (float)std::atof(argv[++i]);
+        else if (arg == "--render-distance" || arg == "-r") opt.renderDistance = std::max(1, std::atoi(argv[++i]));
+        else if (arg == "--budget-ms") opt.budgetMs = std::atof(argv[++i]);
+        else if (arg == "--interval") opt.intervalSeconds = std::atof(argv[++i]);
+        else if (arg == "--save-dir") opt.saveDir = argv[++i];
+        else if (arg == "--out") opt.outPath = argv[++i];
+        else if (arg == "--chunk-pool") opt.chunkPool = std::max(0, std::atoi(argv[++i]));
+    }
+    // 至少跑一帧，否则没有任何采样可汇总
+    if (std::lround(opt.seconds * 60.0) < 1) {
+        std::fprintf(stderr, "--seconds must cover at least one frame (1/60 s)\n");
+        return 1;
+    }
+    std::vector<glm::vec3> path = makePath(opt.path);
+    if (path.empty()) {
+        std::fprintf(stderr, "no waypoints in path '%s'\n", opt.path.c_str());
+        return 1;
+    }
+
+    PerlinNoise noise(123);
+    World world(noise);
+    if (!opt.saveDir.empty()) world.enablePersistence(opt.saveDir);
+    world.setRenderDistance(opt.renderDistance);
+    world.setChunkPoolLimit(opt.chunkPool);
+
+    Player player(path[0]); // 旁观模式：沿相机朝向飞行，不受碰撞影响
+    Frustum frustum;
+    const float farPlane = (opt.renderDistance + 2) * (float)CHUNK_W;
+    const glm::mat4 proj = glm::perspective(glm::radians(60.0f), 16.0f / 9.0f, 0.1f, farPlane);
+    NullUploader uploader;
+    std::vector<Chunk*> visible;
+
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<float> offset(-24.0f, 24.0f);
+    std::uniform_int_distribution<int> height(5, 55);
+    const BlockType editTypes[] = {AIR, AIR, STONE, DIRT, SAND, WATER};
+    std::uniform_int_distribution<int> editType(0, (int)std::size(editTypes) - 1);
+
+    const float dt = 1.0f / 60.0f;
+    const int framesTotal = (int)std::lround(opt.seconds * 60.0);
+    const int framesPerSample = std::max(1, (int)std::lround(opt.intervalSeconds * 60.0));
+    size_t waypoint = path.size() > 1 ? 1 : 0;
+    float editBudget = 0.0f;
+    uint64_t edits = 0;
+    float saveTimer = 0.0f;
+
+    std::vector<Sample> samples;
+    Sample cur{};
+    double frameMsSum = 0.0;
+    uint64_t lastLoaded = 0, lastUnloaded = 0, lastMeshes = 0, lastPatches = 0, lastBytes = 0;
+    uint64_t lastNewChunks = 0, lastHeapAllocations = heapAllocations.load();
+    auto frameStart = Clock::now();
+
+    std::printf("%7s %6s %5s %8s %8s %6s %6s %6s %6s %7s %7s %7s %6s %6s %9s %8s %8s\n", "time", "frames", "over", "avg ms", "max ms",
+                "chunks", "loads", "meshq", "dirty", "load/s", "mesh/s", "edits", "new ch", "pooled", "allocs/s", "rss MB", "peak MB");
+    for (int frame = 1; frame <= framesTotal; ++frame) {
+        auto t0 = Clock::now();
+
+        // 朝下一个路点飞行，到达后转向下一个 (首尾相接循环)
+        glm::vec3 to = path[waypoint] - player.position;
+        if (glm::length(to) < 2.0f) {
+            waypoint = (waypoint + 1) % path.size();
+            to = path[waypoint] - player.position;
+        }
+        if (glm::length(to) > 1e-3f) player.camera.LookAlong(to);
+        bool inputs[6] = {true, false, false, false, false, false};
+        player.update(dt * opt.speed / 15.0f, world, inputs); // 旁观模式固定 15 格/秒，按比例缩放时间步
+
+        // 玩家周围随机编辑 (挖掉或放置)
+        editBudget += opt.editsPerSecond * dt;
+        for (; editBudget >= 1.0f; editBudget -= 1.0f, ++edits) {
+            glm::ivec3 p(glm::floor(player.position + glm::vec3(offset(rng), 0.0f, offset(rng))));
+            world.setBlock(p.x, height(rng), p.z, editTypes[editType(rng)]);
+        }
+
+        world.updateStreaming(player.position);
+        world.processDirtyChunks();
+
+        frustum.update(proj * player.camera.GetViewMatrix());
+        world.updateFocus(player.camera.Pos, frustum);
+        visible.clear();
+        world.cullChunks(frustum, visible);
+        for (Chunk* chunk : visible) uploader.upload(*chunk);
+
+        saveTimer += dt;
+        if (saveTimer >= 10.0f) { world.saveModifiedChunks(); saveTimer = 0.0f; }
+
+        double frameMs = std::chrono::duration<double, std::milli>(Clock::now() - t0).count();
+        cur.frames++;
+        frameMsSum += frameMs;
+        cur.maxFrameMs = std::max(cur.maxFrameMs, frameMs);
+        if (frameMs > opt.budgetMs) cur.overBudget++;
+        cur.pendingLoads = std::max(cur.pendingLoads, world.pendingLoads());
+        cur.pendingMeshJobs = std::max(cur.pendingMeshJobs, world.pendingMeshJobs());
+        cur.dirtyChunks = std::max(cur.dirtyChunks, world.dirtyChunkCount());
+        cur.pendingSaves = std::max(cur.pendingSaves, world.pendingSaves());
+
+        if (frame % framesPerSample == 0 || frame == framesTotal) {
+            double span = cur.frames * dt;
+            cur.time = frame * dt;
+            cur.avgFrameMs = frameMsSum / cur.frames;
+            cur.chunks = world.chunks.size();
+            cur.loadedPerSecond = (world.loadedChunksTotal - lastLoaded) / span;
+            cur.unloadedPerSecond = (world.unloadedChunksTotal - lastUnloaded) / span;
+            cur.meshesPerSecond = (uploader.meshes - lastMeshes) / span;
+            cur.patchesPerSecond = (uploader.patches - lastPatches) / span;
+            cur.uploadMbPerSecond = (uploader.bytes - lastBytes) / 1048576.0 / span;
+            cur.edits = edits;
+            ChunkPool::Stats pool = world.chunkPoolStats();
+            cur.newChunks = pool.allocations - lastNewChunks;
+            cur.pooledChunks = pool.pooled;
+            uint64_t allocations = heapAllocations.load();
+            cur.heapAllocsPerSecond = (allocations - lastHeapAllocations) / span;
+            readRss(cur.rssMb, cur.peakRssMb);
+            samples.push_back(cur);
+            std::printf("%6.0fs %6d %5d %8.2f %8.2f %6zu %6zu %6zu %6zu %7.1f %7.1f %7llu %6llu %6zu %9.0f %8.1f %8.1f\n",
+                        cur.time, cur.frames, cur.overBudget, cur.avgFrameMs, cur.maxFrameMs, cur.chunks,
+                        cur.pendingLoads, cur.pendingMeshJobs, cur.dirtyChunks, cur.loadedPerSecond, cur.meshesPerSecond,
+                        (unsigned long long)cur.edits, (unsigned long long)cur.newChunks, cur.pooledChunks,
+                        cur.heapAllocsPerSecond, cur.rssMb, cur.peakRssMb);
+            std::fflush(stdout);
+
+            lastLoaded = world.loadedChunksTotal;
+            lastUnloaded = world.unloadedChunksTotal;
+            lastMeshes = uploader.meshes;
+            lastPatches = uploader.patches;
+            lastBytes = uploader.bytes;
+            lastNewChunks = pool.allocations;
+            lastHeapAllocations = allocations;
+            cur = Sample{};
+            frameMsSum = 0.0;
+        }
+
+        // 按 60 FPS 的节奏推进，后台线程与真实游戏一样在帧间隙工作
+        if (!opt.fast) {
+            frameStart += std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(dt));
+            std::this_thread::sleep_until(frameStart);
+            if (Clock::now() > frameStart + std::chrono::milliseconds(100)) frameStart = Clock::now(); // 严重落后时不追帧
+        }
+    }
+
+    // 汇总：超标帧、最长帧、最大队列深度、内存增长 (首个与最后一个采样的 RSS 之差，持续增长多半是泄漏)
+    int overBudget = 0;
+    double worstMs = 0.0;
+    size_t maxLoads = 0, maxMeshJobs = 0, maxDirty = 0;
+    for (const Sample& s : samples) {
+        overBudget += s.overBudget;
+        worstMs = std::max(worstMs, s.maxFrameMs);
+        maxLoads = std::max(maxLoads, s.pendingLoads);
+        maxMeshJobs = std::max(maxMeshJobs, s.pendingMeshJobs);
+        maxDirty = std::max(maxDirty, s.dirtyChunks);
+    }
+    double rssGrowth = samples.size() > 1 ? samples.back().rssMb - samples.front().rssMb : 0.0;
+    std::printf("frames over %.1f ms budget: %d / %d, worst frame %.2f ms\n", opt.budgetMs, overBudget, framesTotal, worstMs);
+    std::printf("max queue depth: loads %zu, mesh jobs %zu, dirty chunks %zu\n", maxLoads, maxMeshJobs, maxDirty);
+    std::printf("rss %.1f MB (peak %.1f MB, %+.1f MB since first sample), chunks loaded %llu / unloaded %llu, meshes %llu\n",
+                samples.back().rssMb, samples.back().peakRssMb, rssGrowth,
+                (unsigned long long)world.loadedChunksTotal, (unsigned long long)world.unloadedChunksTotal,
+                (unsigned long long)uploader.meshes);
+    ChunkPool::Stats pool = world.chunkPoolStats();
+    std::printf("chunk pool: %llu allocated, %llu reused, %llu discarded, peak %zu pooled (limit %d)\n",
+                (unsigned long long)pool.allocations, (unsigned long long)pool.reuses,
+                (unsigned long long)pool.discarded, pool.peakPooled, opt.chunkPool);
+    writeJson(opt.outPath, opt, samples);
+    std::printf("samples written to %s\n", opt.outPath.c_str());
+    return 0;
+}
@@ -1,16 +1,39 @@
 #version 450 core
-layout (location = 0) in vec3 aPos;
-layout (location = 1) in vec3 aNormal;
-layout (location = 2) in vec3 aColor;
+// 紧凑顶点：data0 = x(6) | y(9) | z(6) | normal(3)，data1 = block id
+layout (location = 0) in uvec2 aData;
+layout (location = 1) in vec4 aOrigin; // 区块世界坐标偏移 (实例属性，每个间接绘制命令一个)
 
 out vec3 Color;
 out vec3 Normal;
+out float Alpha;
 
 uniform mat4 projection;
 uniform mat4 view;
 
+const vec3 NORMALS[6] = vec3[6](
+    vec3( 1, 0, 0), vec3(-1, 0, 0),
+    vec3( 0, 1, 0), vec3( 0,-1, 0),
+    vec3( 0, 0, 1), vec3( 0, 0,-1)
+);
+
+// 与 Chunk::getColor 保持一致
+vec3 blockColor(uint id, uint n) {
+    if (id == 1u) return (n == 2u) ? vec3(0.25, 0.75, 0.25) : vec3(0.45, 0.32, 0.20); // GRASS 顶面为绿色
+    if (id == 2u) return vec3(0.45, 0.32, 0.20); // DIRT
+    if (id == 3u) return vec3(0.5, 0.5, 0.5);    // STONE
+    if (id == 4u) return vec3(0.2, 0.4, 0.85);   // WATER
+    if (id == 5u) return vec3(0.9, 0.85, 0.6);   // SAND
+    return vec3(1, 0, 1);
+}
+
 void main() {
-    gl_Position = projection * view * vec4(aPos, 1.0);
-    Color = aColor;
-    Normal = aNormal;
-}
\ No newline at end of file
+    uint d = aData.x;
+    vec3 localPos = vec3(float(d & 63u), float((d >> 6) & 511u), float((d >> 15) & 63u));
+    uint n = (d >> 21) & 7u;
+
+    gl_Position = projection * view * vec4(aOrigin.xyz + localPos, 1.0);
+    uint id = aData.y & 255u;
+    Color = blockColor(id, n);
+    Normal = NORMALS[n];
+    Alpha = (id == 4u) ? 0.7 : 1.0; // 水半透明，在半透明那一遍混合 (见 ChunkRenderer)
+}
@@ -0,0 +1,64 @@
+#version 450 core
+// 区块 Hi-Z 遮挡测试：每个调用处理一个间接绘制命令，被遮挡的把 instanceCount 置 0
+layout (local_size_x = 64) in;
+
+struct DrawCommand {
+    uint count;
+    uint instanceCount;
+    uint firstIndex;
+    int baseVertex;
+    uint baseInstance;
+};
+layout (std430, binding = 0) buffer Commands { DrawCommand commands[]; };
+// 每个命令两个 vec4：min (w != 0 表示刚出现的区块，不做测试)、max
+layout (std430, binding = 1) readonly buffer Bounds { vec4 bounds[]; };
+layout (std430, binding = 2) buffer Counter { uint visibleCount; };
+
+layout (binding = 0) uniform sampler2D hiz;
+uniform mat4 viewProj;   // 建金字塔那一帧的矩阵
+uniform ivec2 screenSize;
+uniform int maxLevel;
+uniform int drawCount;
+
+bool occluded(vec3 bmin, vec3 bmax) {
+    vec2 lo = vec2(1e30), hi = vec2(-1e30);
+    float nearest = 1.0;
+    for (int i = 0; i < 8; ++i) {
+        vec3 corner = vec3((i & 1) != 0 ? bmax.x : bmin.x,
+                           (i & 2) != 0 ? bmax.y : bmin.y,
+                           (i & 4) != 0 ? bmax.z : bmin.z);
+        vec4 clip = viewProj * vec4(corner, 1.0);
+        if (clip.w <= 1e-4) return false; // 跨过相机平面，投影无意义
+        vec3 ndc = clip.xyz / clip.w;
+        lo = min(lo, ndc.xy);
+        hi = max(hi, ndc.xy);
+        nearest = min(nearest, ndc.z * 0.5 + 0.5);
+    }
+    // 有一部分在那一帧的画面之外，那里的深度未知
+    if (any(lessThan(lo, vec2(-1.0))) || any(greaterThan(hi, vec2(1.0)))) return false;
+
+    ivec2 a = clamp(ivec2((lo * 0.5 + 0.5) * vec2(screenSize)), ivec2(0), screenSize - 1);
+    ivec2 b = clamp(ivec2((hi * 0.5 + 0.5) * vec2(screenSize)), ivec2(0), screenSize - 1);
+
+    // 选最细的一级，使包围矩形在该级最多跨 2x2 个纹素
+    int level = 0;
+    while (level < maxLevel && any(greaterThan((b >> level) - (a >> level), ivec2(1)))) level++;
+    ivec2 size = textureSize(hiz, level);
+    ivec2 ta = min(a >> level, size - 1);
+    ivec2 tb = min(b >> level, size - 1);
+
+    float farthest = max(max(texelFetch(hiz, ta, level).r, texelFetch(hiz, ivec2(tb.x, ta.y), level).r),
+                         max(texelFetch(hiz, ivec2(ta.x, tb.y), level).r, texelFetch(hiz, tb, level).r));
+    return nearest > farthest;
+}
+
+void main() {
+    uint i = gl_GlobalInvocationID.x;
+    if (i >= uint(drawCount)) return;
+
+    vec4 bmin = bounds[i * 2u];
+    vec4 bmax = bounds[i * 2u + 1u];
+    bool visible = bmin.w != 0.0 || !occluded(bmin.xyz, bmax.xyz);
+    commands[i].instanceCount = visible ? 1u : 0u;
+    if (visible) atomicAdd(visibleCount, 1u);
+}
@@ -0,0 +1,32 @@
+#version 450 core
+// Hi-Z 金字塔的一级：每个输出纹素取其覆盖的源纹素中的最大深度 (最远)，遮挡测试因此是保守的
+layout (local_size_x = 8, local_size_y = 8) in;
+
+layout (binding = 0) uniform sampler2D src;
+layout (r32f, binding = 0) writeonly uniform image2D dst;
+
+uniform int copyLevel; // 第 0 级：从深度纹理 1:1 拷贝
+uniform int srcLevel;
+uniform ivec2 srcSize;
+uniform ivec2 dstSize;
+
+void main() {
+    ivec2 p = ivec2(gl_GlobalInvocationID.xy);
+    if (any(greaterThanEqual(p, dstSize))) return;
+
+    if (copyLevel != 0) {
+        imageStore(dst, p, vec4(texelFetch(src, p, 0).r));
+        return;
+    }
+
+    // 源尺寸为奇数时最后一行 / 列多并入一个纹素，保证每个源纹素都被覆盖
+    ivec2 last = ivec2(1);
+    if (p.x == dstSize.x - 1 && (srcSize.x & 1) == 1) last.x = 2;
+    if (p.y == dstSize.y - 1 && (srcSize.y & 1) == 1) last.y = 2;
+
+    float depth = 0.0;
+    for (int y = 0; y <= last.y; ++y)
+        for (int x = 0; x <= last.x; ++x)
+            depth = max(depth, texelFetch(src, min(p * 2 + ivec2(x, y), srcSize - 1), srcLevel).r);
+    imageStore(dst, p, vec4(depth));
+}
@@ -0,0 +1,109 @@
+#include "JobSystem.hpp"
+#include <algorithm>
+#include "Profiler.hpp"
+
+JobSystem::JobSystem(unsigned threadCount, const char* name) {
+    if (threadCount == 0) {
+        unsigned hw = std::thread::hardware_concurrency();
+        threadCount = hw > 1 ? hw - 1 : 1;
+    }
+    workers.reserve(threadCount);
+    for (unsigned i = 0; i < threadCount; ++i)
+        workers.emplace_back(&JobSystem::workerLoop, this, name);
+}
+
+JobSystem::~JobSystem() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+        queue.clear();
+        blocked.clear();
+        queuedTags.clear();
+    }
+    hasWork.notify_all();
+    for (auto& t : workers) t.join();
+}
+
+void JobSystem::submit(uint64_t tag, float priority, Task task) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (stopping) return;
+        // 已有同 tag 任务在排队：它执行时会读到最新数据，新的提交直接合并掉
+        if (!queuedTags.insert(tag).second) return;
+
+        Job job{priority, nextSeq++, tag, std::move(task)};
+        if (runningTags.count(tag)) {
+            blocked.emplace(tag, std::move(job));
+            return;
+        }
+        queue.push_back(std::move(job));
+        std::push_heap(queue.begin(), queue.end(), later);
+    }
+    hasWork.notify_one();
+}
+
+void JobSystem::dropQueued(uint64_t tag) {
+    if (!queuedTags.erase(tag) || blocked.erase(tag)) return;
+    auto it = std::find_if(queue.begin(), queue.end(), [&](const Job& j) { return j.tag == tag; });
+    if (it != queue.end()) {
+        queue.erase(it);
+        std::make_heap(queue.begin(), queue.end(), later);
+    }
+}
+
+void JobSystem::cancel(uint64_t tag) {
+    std::unique_lock<std::mutex> lock(mutex);
+    dropQueued(tag);
+    jobDone.wait(lock, [&] { return runningTags.count(tag) == 0; });
+}
+
+void JobSystem::cancelQueued(uint64_t tag) {
+    std::lock_guard<std::mutex> lock(mutex);
+    dropQueued(tag);
+}
+
+void JobSystem::reprioritize(const std::function<float(uint64_t)>& priorityOf) {
+    std::lock_guard<std::mutex> lock(mutex);
+    for (auto& job : queue) job.priority = priorityOf(job.tag);
+    for (auto& [tag, job] : blocked) job.priority = priorityOf(tag);
+    std::make_heap(queue.begin(), queue.end(), later);
+}
+
+size_t JobSystem::pending() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return queuedTags.size();
+}
+
+bool JobSystem::busy(uint64_t tag) const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return queuedTags.count(tag) || runningTags.count(tag);
+}
+
+void JobSystem::workerLoop(const char* name) {
+    Profiler::get().setThreadName(name);
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        hasWork.wait(lock, [&] { return stopping || !queue.empty(); });
+        if (stopping) return;
+
+        std::pop_heap(queue.begin(), queue.end(), later);
+        Job job = std::move(queue.back());
+        queue.pop_back();
+        queuedTags.erase(job.tag);
+        runningTags.insert(job.tag);
+
+        lock.unlock();
+        job.task();
+        lock.lock();
+
+        runningTags.erase(job.tag);
+        auto it = blocked.find(job.tag);
+        if (it != blocked.end()) {
+            queue.push_back(std::move(it->second));
+            blocked.erase(it);
+            std::push_heap(queue.begin(), queue.end(), later);
+            hasWork.notify_one();
+        }
+        jobDone.notify_all();
+    }
+}
@@ -0,0 +1,66 @@
+#pragma once
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+// 固定大小的后台线程池
+// 任务按 priority 从小到大执行 (越小越优先)，tag 标识任务所属对象 (例如区块坐标)：
+//  - 同一 tag 同时最多排队一个任务，重复提交会被合并
+//  - 同一 tag 的任务不会并发执行
+//  - cancel(tag) 丢弃排队中的任务，并等待正在执行的任务结束
+//  - cancelQueued(tag) 只丢弃排队中的任务，不等待正在执行的任务 (任务不引用调用方即将释放的数据时使用)
+class JobSystem {
+public:
+    using Task = std::function<void()>;
+
+    // threadCount = 0 时按 CPU 核心数创建 (留一个核给主线程)；name 为线程在性能分析 trace 中的名字
+    explicit JobSystem(unsigned threadCount = 0, const char* name = "worker");
+    ~JobSystem();
+
+    JobSystem(const JobSystem&) = delete;
+    JobSystem& operator=(const JobSystem&) = delete;
+
+    void submit(uint64_t tag, float priority, Task task);
+    void cancel(uint64_t tag);
+    void cancelQueued(uint64_t tag);
+
+    // 按新的优先级函数重排整个队列 (在持锁状态下调用 priorityOf，须足够轻量)
+    void reprioritize(const std::function<float(uint64_t)>& priorityOf);
+
+    size_t pending() const;
+    // tag 是否有任务在排队或正在执行
+    bool busy(uint64_t tag) const;
+    unsigned threadCount() const { return (unsigned)workers.size(); }
+
+private:
+    struct Job {
+        float priority;
+        uint64_t seq;
+        uint64_t tag;
+        Task task;
+    };
+    // 小顶堆比较：priority 小的先出，相同时先提交的先出
+    static bool later(const Job& a, const Job& b) {
+        if (a.priority != b.priority) return a.priority > b.priority;
+        return a.seq > b.seq;
+    }
+
+    void workerLoop(const char* name);
+    void dropQueued(uint64_t tag); // 调用方须持有 mutex
+
+    mutable std::mutex mutex;
+    std::condition_variable hasWork;
+    std::condition_variable jobDone;
+    std::vector<Job> queue;                      // 堆
+    std::unordered_map<uint64_t, Job> blocked;   // 同 tag 任务正在执行，等其结束再入堆
+    std::unordered_set<uint64_t> queuedTags;     // queue + blocked 中的 tag
+    std::unordered_set<uint64_t> runningTags;
+    uint64_t nextSeq = 0;
+    bool stopping = false;
+    std::vector<std::thread> workers;
+};
@@ -0,0 +1,74 @@
+#include "MappedFile.hpp"
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+
+bool MappedFile::open(const std::string& path) {
+    close();
+    // 允许其它句柄同时读写 (后台存档线程会追加写入)
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr,
+                              OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) return false;
+
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart == 0) { CloseHandle(file); return false; }
+
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!mapping) { CloseHandle(file); return false; }
+
+    void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (!view) { CloseHandle(mapping); CloseHandle(file); return false; }
+
+    fileHandle = file;
+    mappingHandle = mapping;
+    ptr = static_cast<const uint8_t*>(view);
+    length = (size_t)fileSize.QuadPart;
+    return true;
+}
+
+void MappedFile::close() {
+    if (ptr) UnmapViewOfFile(ptr);
+    if (mappingHandle) CloseHandle(mappingHandle);
+    if (fileHandle) CloseHandle(fileHandle);
+    ptr = nullptr;
+    mappingHandle = fileHandle = nullptr;
+    length = 0;
+}
+
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+bool MappedFile::open(const std::string& path) {
+    close();
+    int f = ::open(path.c_str(), O_RDONLY);
+    if (f < 0) return false;
+
+    struct stat st;
+    if (fstat(f, &st) != 0 || st.st_size == 0) { ::close(f); return false; }
+
+    void* view = mmap(nullptr, (size_t)st.st_size, PROT_READ, MAP_SHARED, f, 0);
+    if (view == MAP_FAILED) { ::close(f); return false; }
+
+    fd = f;
+    ptr = static_cast<const uint8_t*>(view);
+    length = (size_t)st.st_size;
+    return true;
+}
+
+void MappedFile::close() {
+    if (ptr) munmap(const_cast<uint8_t*>(ptr), length);
+    if (fd >= 0) ::close(fd);
+    ptr = nullptr;
+    fd = -1;
+    length = 0;
+}
+#endif
@@ -0,0 +1,31 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// 只读内存映射文件 (Windows: CreateFileMapping，其它平台: mmap)
+// 映射整个文件；文件被其它句柄改写/追加后需重新 open 才能看到新增部分
+class MappedFile {
+public:
+    MappedFile() = default;
+    ~MappedFile() { close(); }
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    bool open(const std::string& path);
+    void close();
+
+    const uint8_t* data() const { return ptr; }
+    size_t size() const { return length; }
+    bool isOpen() const { return ptr != nullptr; }
+
+private:
+    const uint8_t* ptr = nullptr;
+    size_t length = 0;
+#ifdef _WIN32
+    void* fileHandle = nullptr;
+    void* mappingHandle = nullptr;
+#else
+    int fd = -1;
+#endif
+};
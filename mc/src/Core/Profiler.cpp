@@ -0,0 +1,111 @@
+#include "Profiler.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+
+namespace {
+// GPU 轨道的线程号 (不与真实线程冲突)
+constexpr int GPU_TID = 1000;
+// 录制结束后再等几帧：GPU 查询结果通常落后 1~3 帧
+constexpr int DRAIN_FRAMES = 4;
+
+thread_local int cachedTid = -1;
+}
+
+Profiler& Profiler::get() {
+    static Profiler instance;
+    return instance;
+}
+
+int Profiler::threadId() {
+    if (cachedTid < 0) {
+        cachedTid = (int)threadNames.size();
+        threadNames.push_back("thread " + std::to_string(cachedTid));
+    }
+    return cachedTid;
+}
+
+void Profiler::setThreadName(const char* name) {
+    std::lock_guard<std::mutex> lock(mutex);
+    threadNames[threadId()] = name;
+}
+
+void Profiler::startCapture(int frames, const std::string& path) {
+    if (startPending || isBusy() || frames <= 0) return;
+    startPending = true;
+    framesLeft = frames;
+    outputPath = path;
+}
+
+Profiler::FrameResult Profiler::beginFrame() {
+    Clock::time_point now = Clock::now();
+    if (startPending) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            events.clear(); // 上次录制结束后才到的区间
+        }
+        startPending = false;
+        frameStart = now;
+        capturing.store(true, std::memory_order_relaxed);
+        return FrameResult::None;
+    }
+    if (isCapturing()) {
+        addSpan("frame", "frame", frameStart, now);
+        frameStart = now;
+        if (--framesLeft == 0) {
+            capturing.store(false, std::memory_order_relaxed);
+            drainFrames = DRAIN_FRAMES;
+        }
+        return FrameResult::None;
+    }
+    if (drainFrames > 0 && --drainFrames == 0)
+        return writeTrace(outputPath) ? FrameResult::TraceWritten : FrameResult::WriteFailed;
+    return FrameResult::None;
+}
+
+void Profiler::addSpan(const char* name, const char* category, Clock::time_point begin, Clock::time_point end) {
+    std::lock_guard<std::mutex> lock(mutex);
+    events.push_back({name, category, begin, end, threadId()});
+}
+
+void Profiler::addGpuSpan(const char* name, Clock::time_point begin, Clock::time_point end) {
+    std::lock_guard<std::mutex> lock(mutex);
+    events.push_back({name, "gpu", begin, end, GPU_TID});
+}
+
+bool Profiler::writeTrace(const std::string& path) {
+    std::vector<Event> captured;
+    std::vector<std::string> names;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        captured.swap(events);
+        names = threadNames;
+    }
+    std::ofstream f(path);
+    if (!f) return false;
+
+    // 时间以最早的区间为零点，单位微秒
+    Clock::time_point origin = captured.empty() ? Clock::now() : captured.front().begin;
+    for (const Event& e : captured) origin = std::min(origin, e.begin);
+    auto us = [&](Clock::duration d) { return std::chrono::duration<double, std::micro>(d).count(); };
+
+    f << "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [\n";
+    char line[256];
+    for (size_t tid = 0; tid < names.size(); ++tid) {
+        std::snprintf(line, sizeof(line),
+                      "{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 1, \"tid\": %zu, \"args\": {\"name\": \"%s\"}},\n",
+                      tid, names[tid].c_str());
+        f << line;
+    }
+    std::snprintf(line, sizeof(line),
+                  "{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 1, \"tid\": %d, \"args\": {\"name\": \"GPU\"}}", GPU_TID);
+    f << line;
+    for (const Event& e : captured) {
+        std::snprintf(line, sizeof(line),
+                      ",\n{\"name\": \"%s\", \"cat\": \"%s\", \"ph\": \"X\", \"pid\": 1, \"tid\": %d, \"ts\": %.3f, \"dur\": %.3f}",
+                      e.name, e.category, e.tid, us(e.begin - origin), us(e.end - e.begin));
+        f << line;
+    }
+    f << "\n]}\n";
+    return (bool)f;
+}
@@ -0,0 +1,85 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// 帧性能分析：录制若干帧内各阶段的起止时间 (主线程作用域、后台线程任务、GPU 各遍)，导出 Chrome trace JSON
+// (chrome://tracing 或 ui.perfetto.dev 打开)，每个线程一条轨道，GPU 单独一条
+// 不录制时作用域计时只读一个原子标志，不取时间、不加锁
+class Profiler {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    static Profiler& get();
+
+    // 从下一帧开始录制 frames 帧，结束后写入 path (录制或写文件之前调用无效)
+    void startCapture(int frames, const std::string& path);
+    bool isCapturing() const { return capturing.load(std::memory_order_relaxed); }
+    // 录制结束但 GPU 结果还没收齐 (GpuTimer 据此继续回读已发出的查询)
+    bool isBusy() const { return capturing.load(std::memory_order_relaxed) || drainFrames > 0; }
+
+    enum class FrameResult { None, TraceWritten, WriteFailed };
+    // 主线程每帧开头调用：记录上一帧的 frame 区间，录满后停止；再等几帧收齐 GPU 结果后写文件，
+    // 写文件的那一帧返回结果，供调用方提示
+    FrameResult beginFrame();
+    const std::string& tracePath() const { return outputPath; }
+
+    // 线程安全；name / category 须为字符串常量 (只保存指针)
+    void addSpan(const char* name, const char* category, Clock::time_point begin, Clock::time_point end);
+    // GPU 时间线上的区间 (已换算到 CPU 时钟)，放在单独的 GPU 轨道
+    void addGpuSpan(const char* name, Clock::time_point begin, Clock::time_point end);
+    // 当前线程在 trace 中显示的名字 (线程启动时调用一次)
+    void setThreadName(const char* name);
+
+    bool writeTrace(const std::string& path);
+
+private:
+    Profiler() = default;
+
+    struct Event {
+        const char* name;
+        const char* category;
+        Clock::time_point begin, end;
+        int tid;
+    };
+
+    int threadId(); // 调用方须持有 mutex
+
+    std::atomic<bool> capturing{false};
+    bool startPending = false; // 以下仅主线程
+    int framesLeft = 0;
+    int drainFrames = 0;
+    std::string outputPath;
+    Clock::time_point frameStart;
+
+    std::mutex mutex;
+    std::vector<Event> events;
+    std::vector<std::string> threadNames; // 下标为 tid
+};
+
+// 作用域计时：构造时开始，析构时记录 (只在录制期间)
+class ProfileScope {
+public:
+    explicit ProfileScope(const char* name, const char* category = "cpu")
+        : name(name), category(category), active(Profiler::get().isCapturing()) {
+        if (active) begin = Profiler::Clock::now();
+    }
+    ~ProfileScope() {
+        if (active) Profiler::get().addSpan(name, category, begin, Profiler::Clock::now());
+    }
+    ProfileScope(const ProfileScope&) = delete;
+    ProfileScope& operator=(const ProfileScope&) = delete;
+
+private:
+    const char* name;
+    const char* category;
+    bool active;
+    Profiler::Clock::time_point begin;
+};
+
+#define PROFILE_CONCAT_(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_(a, b)
+#define PROFILE_SCOPE(...) ProfileScope PROFILE_CONCAT(profileScope_, __LINE__)(__VA_ARGS__)
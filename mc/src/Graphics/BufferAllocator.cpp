@@ -0,0 +1,50 @@
+#include "BufferAllocator.hpp"
+
+BufferAllocator::BufferAllocator(size_t capacity) {
+    grow(capacity);
+}
+
+size_t BufferAllocator::allocate(size_t size) {
+    if (size == 0) return npos;
+    for (auto it = freeBlocks.begin(); it != freeBlocks.end(); ++it) {
+        if (it->second < size) continue;
+        size_t offset = it->first;
+        size_t remain = it->second - size;
+        freeBlocks.erase(it);
+        if (remain) freeBlocks.emplace(offset + size, remain);
+        inUse += size;
+        return offset;
+    }
+    return npos;
+}
+
+void BufferAllocator::free(size_t offset, size_t size) {
+    if (size == 0 || offset == npos) return;
+    inUse -= size;
+    insertFree(offset, size);
+}
+
+void BufferAllocator::grow(size_t newCapacity) {
+    if (newCapacity <= total) return;
+    size_t oldTotal = total;
+    total = newCapacity;
+    insertFree(oldTotal, newCapacity - oldTotal);
+}
+
+void BufferAllocator::insertFree(size_t offset, size_t size) {
+    auto next = freeBlocks.lower_bound(offset);
+    // 与后一个空闲块相接则合并
+    if (next != freeBlocks.end() && offset + size == next->first) {
+        size += next->second;
+        next = freeBlocks.erase(next);
+    }
+    // 与前一个空闲块相接则合并
+    if (next != freeBlocks.begin()) {
+        auto prev = std::prev(next);
+        if (prev->first + prev->second == offset) {
+            prev->second += size;
+            return;
+        }
+    }
+    freeBlocks.emplace(offset, size);
+}
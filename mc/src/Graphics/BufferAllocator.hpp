@@ -0,0 +1,26 @@
+#pragma once
+#include <cstddef>
+#include <map>
+
+// 大缓冲内的区间分配器 (只管理偏移，不接触 GL)
+// 首次适配 + 释放时合并相邻空闲块；单位由调用方决定 (区块网格按顶点数)
+class BufferAllocator {
+public:
+    static constexpr size_t npos = (size_t)-1;
+
+    explicit BufferAllocator(size_t capacity = 0);
+
+    size_t allocate(size_t size);          // 失败返回 npos
+    void free(size_t offset, size_t size);
+    void grow(size_t newCapacity);         // 扩容，新增部分并入空闲区
+
+    size_t capacity() const { return total; }
+    size_t used() const { return inUse; }
+    size_t freeBlockCount() const { return freeBlocks.size(); }
+
+private:
+    size_t total = 0;
+    size_t inUse = 0;
+    std::map<size_t, size_t> freeBlocks; // offset -> size
+    void insertFree(size_t offset, size_t size);
+};
@@ -1,5 +1,6 @@
 // Camera.cpp
 #include "Camera.hpp"
+#include <cmath>
 
 Camera::Camera(glm::vec3 pos) : Pos(pos), WorldUp({0,1,0}), Yaw(-90.0f), Pitch(0.0f) {
     updateVectors();
@@ -27,6 +28,15 @@ void Camera::ProcessMouse(float xoff, float yoff) {
     updateVectors();
 }
 
+void Camera::LookAlong(const glm::vec3& dir) {
+    glm::vec3 d = glm::normalize(dir);
+    Yaw = glm::degrees(std::atan2(d.z, d.x));
+    Pitch = glm::degrees(std::asin(d.y));
+    if (Pitch > 89.0f) Pitch = 89.0f;
+    if (Pitch < -89.0f) Pitch = -89.0f;
+    updateVectors();
+}
+
 void Camera::updateVectors() {
     glm::vec3 f;
     f.x = cos(glm::radians(Yaw)) * cos(glm::radians(Pitch));
@@ -12,6 +12,8 @@ public:
     glm::mat4 GetViewMatrix() const;
     void ProcessKey(int direction, float deltaTime);
     void ProcessMouse(float xoffset, float yoffset);
+    // 朝向 direction (无需归一化)，脚本驱动相机时用
+    void LookAlong(const glm::vec3& direction);
 
 private:
     void updateVectors();
@@ -0,0 +1,356 @@
+#include "ChunkRenderer.hpp"
+#include "QuadIndexBuffer.hpp"
+#include "../World/Chunk.hpp"
+#include "../Core/Profiler.hpp"
+#include <algorithm>
+#include <cstring>
+
+#ifndef GL_FRAGMENT_SHADER_INVOCATIONS_ARB
+#define GL_FRAGMENT_SHADER_INVOCATIONS_ARB 0x82F4
+#endif
+
+ChunkRenderer::ChunkRenderer(size_t initialVertices) : allocator(initialVertices) {
+    glGenVertexArrays(1, &vao);
+    glGenBuffers(1, &vertexBuffer);
+    glGenBuffers(1, &originBuffer);
+    glGenBuffers(1, &indirectBuffer);
+    glGenBuffers(1, &boundsBuffer);
+
+    glBindBuffer(GL_ARRAY_BUFFER, vertexBuffer);
+    glBufferData(GL_ARRAY_BUFFER, initialVertices * sizeof(Vertex), nullptr, GL_DYNAMIC_DRAW);
+
+    glBindVertexArray(vao);
+    bindVertexBuffer();
+
+    // 区块原点：每个绘制命令一个实例，baseInstance 即命令下标
+    glBindBuffer(GL_ARRAY_BUFFER, originBuffer);
+    glVertexAttribPointer(1, 4, GL_FLOAT, GL_FALSE, sizeof(glm::vec4), (void*)0);
+    glVertexAttribDivisor(1, 1);
+    glEnableVertexAttribArray(1);
+
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, QuadIndexBuffer::reserve(1));
+    glBindVertexArray(0);
+
+    GLint extensions = 0;
+    glGetIntegerv(GL_NUM_EXTENSIONS, &extensions);
+    for (GLint i = 0; i < extensions && !fragmentQuerySupported; ++i)
+        fragmentQuerySupported = std::strcmp((const char*)glGetStringi(GL_EXTENSIONS, i), "GL_ARB_pipeline_statistics_query") == 0;
+    if (fragmentQuerySupported) glGenQueries(2, fragmentQueries);
+}
+
+ChunkRenderer::~ChunkRenderer() {
+    glDeleteVertexArrays(1, &vao);
+    glDeleteBuffers(1, &vertexBuffer);
+    glDeleteBuffers(1, &originBuffer);
+    glDeleteBuffers(1, &indirectBuffer);
+    glDeleteBuffers(1, &boundsBuffer);
+    if (fragmentQuerySupported) glDeleteQueries(2, fragmentQueries);
+}
+
+void ChunkRenderer::bindVertexBuffer() {
+    glBindBuffer(GL_ARRAY_BUFFER, vertexBuffer);
+    glVertexAttribIPointer(0, 2, GL_UNSIGNED_INT, sizeof(Vertex), (void*)0);
+    glEnableVertexAttribArray(0);
+}
+
+void ChunkRenderer::growVertexBuffer(size_t minVertices) {
+    size_t oldCapacity = allocator.capacity();
+    size_t newCapacity = std::max<size_t>(oldCapacity * 2, 1 << 16);
+    while (newCapacity < minVertices) newCapacity *= 2;
+
+    // 新建更大的缓冲并在 GPU 端拷贝旧内容，已分配区间的偏移保持不变
+    GLuint newBuffer;
+    glGenBuffers(1, &newBuffer);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, newBuffer);
+    glBufferData(GL_COPY_WRITE_BUFFER, newCapacity * sizeof(Vertex), nullptr, GL_DYNAMIC_DRAW);
+    glBindBuffer(GL_COPY_READ_BUFFER, vertexBuffer);
+    glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, 0, oldCapacity * sizeof(Vertex));
+    glDeleteBuffers(1, &vertexBuffer);
+    vertexBuffer = newBuffer;
+
+    glBindVertexArray(vao);
+    bindVertexBuffer();
+    glBindVertexArray(0);
+    allocator.grow(newCapacity);
+}
+
+// 切面余量：已有四边形的切面留约 25%，至少一个；余量用退化四边形 (四个顶点相同，面积为 0) 填充
+// 空切面 (全空气 / 全实心的层、大部分区块的半透明切面) 不留余量，否则每个区块要多传、多画近 300 个退化四边形；
+// 在空切面里编辑时整块重新排布 (只拷贝 CPU 端的顶点，不重新构建网格)
+static uint32_t sliceCapacity(uint32_t count) {
+    if (count == 0) return 0;
+    return count + 4 * std::max<uint32_t>(1, count / 16);
+}
+
+void ChunkRenderer::uploadChunks(const std::vector<Chunk*>& chunks) {
+    // 只有切面补丁的区块直接应用 (编辑的反馈不等待，数据量也小)；有新网格的按距离排队
+    pendingUploads.clear();
+    for (Chunk* chunk : chunks) {
+        if (chunk->hasPendingMesh()) pendingUploads.push_back({chunk, distance2(*chunk)});
+        else if (!chunk->slicePatches.empty()) upload(*chunk);
+    }
+    std::sort(pendingUploads.begin(), pendingUploads.end(),
+              [](const PendingUpload& a, const PendingUpload& b) { return a.distance2 < b.distance2; });
+    // 超出预算的网格不取走，留在区块里 (期间仍画旧网格)，下一帧重新按距离排队；每帧至少上传最近的一个
+    bool uploadedMesh = false;
+    for (const PendingUpload& pending : pendingUploads) {
+        if (uploadedMesh && uploadedBytes >= uploadBudget) {
+            deferredMeshes++;
+            continue;
+        }
+        upload(*pending.chunk);
+        uploadedMesh = true;
+    }
+    stagingRing.endFrame();
+}
+
+void ChunkRenderer::writeVertices(size_t vertexOffset, const Vertex* vertices, size_t count) {
+    size_t bytes = count * sizeof(Vertex);
+    size_t ringOffset;
+    uint8_t* dst = stagingRing.allocate(bytes, ringOffset);
+    if (dst) {
+        std::memcpy(dst, vertices, bytes);
+        glBindBuffer(GL_COPY_READ_BUFFER, stagingRing.buffer());
+        glBindBuffer(GL_COPY_WRITE_BUFFER, vertexBuffer);
+        glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, ringOffset, vertexOffset * sizeof(Vertex), bytes);
+    } else {
+        glBindBuffer(GL_ARRAY_BUFFER, vertexBuffer);
+        glBufferSubData(GL_ARRAY_BUFFER, vertexOffset * sizeof(Vertex), bytes, vertices);
+        stagingFallbacks++;
+    }
+    uploadedBytes += bytes;
+}
+
+float ChunkRenderer::distance2(const Chunk& chunk) const {
+    glm::vec3 center = glm::vec3(chunk.worldPos) + glm::vec3(CHUNK_W, CHUNK_H, CHUNK_W) * 0.5f;
+    glm::vec3 d = center - cameraPos;
+    return glm::dot(d, d);
+}
+
+void ChunkRenderer::upload(Chunk& chunk) {
+    bool replaced = chunk.takeMesh(staging);
+    if (replaced) {
+        uploadLayout(chunk, staging);
+        chunk.meshUploaded = true;
+    }
+    if (!chunk.meshUploaded) return; // 还没有完整网格，补丁等整体结果
+
+    replaced |= !chunk.slicePatches.empty();
+    for (const SlicePatch& patch : chunk.slicePatches) applyPatch(chunk, patch);
+    chunk.slicePatches.clear();
+
+    // 被编辑或切换 LOD 的区块换上新网格：上一帧的深度里还是旧的几何，本帧不能拿它做遮挡测试
+    // (新加载的区块、邻居加载引起的边界重建不会让原本挡住的东西露出来，不影响)
+    if (replaced && chunk.editedSinceUpload) {
+        geometryChanged = true;
+        chunk.editedSinceUpload = false;
+    }
+}
+
+void ChunkRenderer::uploadLayout(Chunk& chunk, const ChunkMesh& mesh) {
+    PROFILE_SCOPE("upload mesh");
+    ChunkMeshLayout& layout = chunk.meshLayout;
+    layout.vertices.clear();
+    for (int s = 0; s < MESH_SLICE_COUNT; ++s) {
+        uint32_t count = (uint32_t)mesh.sliceSize(s);
+        layout.start[s] = (uint32_t)layout.vertices.size();
+        layout.count[s] = count;
+        layout.capacity[s] = sliceCapacity(count);
+        layout.vertices.insert(layout.vertices.end(), mesh.vertices.begin() + mesh.sliceOffsets[s],
+                               mesh.vertices.begin() + mesh.sliceOffsets[s + 1]);
+        layout.vertices.resize(layout.start[s] + layout.capacity[s], Vertex{0, 0});
+    }
+
+    release(chunk);
+    size_t count = layout.vertices.size();
+    if (count == 0) return; // 没有任何面 (例如全空气)，不占缓冲
+    size_t offset = allocator.allocate(count);
+    if (offset == BufferAllocator::npos) {
+        growVertexBuffer(allocator.used() + count);
+        offset = allocator.allocate(count);
+    }
+    writeVertices(offset, layout.vertices.data(), count);
+
+    chunk.meshOffset = offset;
+    chunk.meshVertexCount = count;
+    maxQuads = std::max(maxQuads, count / 4);
+}
+
+void ChunkRenderer::applyPatch(Chunk& chunk, const SlicePatch& patch) {
+    ChunkMeshLayout& layout = chunk.meshLayout;
+    int s = patch.slice;
+    uint32_t count = (uint32_t)patch.vertices.size();
+
+    if (count > layout.capacity[s]) {
+        // 余量不够：按新的切面内容重新排布整个区块
+        staging.clear();
+        for (int i = 0; i < MESH_SLICE_COUNT; ++i) {
+            staging.sliceOffsets[i] = (uint32_t)staging.vertices.size();
+            if (i == s) {
+                staging.vertices.insert(staging.vertices.end(), patch.vertices.begin(), patch.vertices.end());
+            } else {
+                auto begin = layout.vertices.begin() + layout.start[i];
+                staging.vertices.insert(staging.vertices.end(), begin, begin + layout.count[i]);
+            }
+        }
+        staging.sliceOffsets[MESH_SLICE_COUNT] = (uint32_t)staging.vertices.size();
+        uploadLayout(chunk, staging);
+        return;
+    }
+
+    // 原地覆盖：新顶点 + 把旧内容中多出来的部分改成退化四边形，只上传这一段
+    uint32_t dirty = std::max(count, layout.count[s]);
+    Vertex* dst = layout.vertices.data() + layout.start[s];
+    std::copy(patch.vertices.begin(), patch.vertices.end(), dst);
+    std::fill(dst + count, dst + dirty, Vertex{0, 0});
+    layout.count[s] = count;
+    if (dirty == 0) return;
+
+    writeVertices(chunk.meshOffset + layout.start[s], dst, dirty);
+    patchedSlices++;
+}
+
+void ChunkRenderer::release(Chunk& chunk) {
+    if (chunk.meshVertexCount == 0) return;
+    allocator.free(chunk.meshOffset, chunk.meshVertexCount);
+    chunk.meshOffset = 0;
+    chunk.meshVertexCount = 0;
+}
+
+void ChunkRenderer::beginFrame(const glm::vec3& pos) {
+    items.clear();
+    cameraPos = pos;
+    frame++;
+    geometryChanged = false;
+    drawCalls = 0;
+    drawnChunks = 0;
+    patchedSlices = 0;
+    uploadedBytes = 0;
+    deferredMeshes = 0;
+}
+
+void ChunkRenderer::addDraw(Chunk& chunk) {
+    if (chunk.meshVertexCount == 0) return;
+    DrawItem item;
+    item.chunk = &chunk;
+    item.distance2 = distance2(chunk);
+
+    // 遮挡测试用的包围盒只取非空的段，地表区块上方大片空气不算在内
+    int lo = 0, hi = SECTION_COUNT - 1;
+    while (lo < hi && chunk.blocks.sections[lo].isEmpty()) lo++;
+    while (hi > lo && chunk.blocks.sections[hi].isEmpty()) hi--;
+    // 上一帧没有提交过 (新加载 / 刚进入视野) 的区块不在上一帧的画面里，不做测试
+    bool fresh = chunk.drawnFrame + 1 != frame;
+    chunk.drawnFrame = frame;
+    glm::vec3 base(chunk.worldPos);
+    item.boundsMin = glm::vec4(base + glm::vec3(0, lo * SECTION_H, 0), fresh ? 1.0f : 0.0f);
+    item.boundsMax = glm::vec4(base + glm::vec3(CHUNK_W, (hi + 1) * SECTION_H, CHUNK_W), 0.0f);
+    items.push_back(item);
+}
+
+void ChunkRenderer::pushCommand(const DrawItem& item, uint32_t first, uint32_t count) {
+    DrawCommand cmd;
+    cmd.count = (GLuint)(count / 4 * 6);
+    cmd.instanceCount = 1;
+    cmd.firstIndex = 0;
+    cmd.baseVertex = (GLint)(item.chunk->meshOffset + first);
+    cmd.baseInstance = (GLuint)commands.size();
+    commands.push_back(cmd);
+    origins.emplace_back(glm::vec3(item.chunk->worldPos), 1.0f);
+    bounds.push_back(item.boundsMin);
+    bounds.push_back(item.boundsMax);
+}
+
+void ChunkRenderer::streamBuffer(GLenum target, GLuint buffer, size_t& capacity, size_t bytes, const void* data) {
+    glBindBuffer(target, buffer);
+    if (bytes > capacity) {
+        capacity = bytes * 2;
+        glBufferData(target, capacity, nullptr, GL_STREAM_DRAW);
+    }
+    glBufferSubData(target, 0, bytes, data);
+}
+
+void ChunkRenderer::draw(HiZCuller* occlusion) {
+    drawnChunks = (int)items.size();
+    occlusionTested = false;
+    commands.clear();
+    origins.clear();
+    bounds.clear();
+
+    size_t opaqueDraws;
+    if (sortedPasses) {
+        // 不透明：从近到远；半透明：从远到近 (区块粒度，区块内部的水面大多在同一高度)
+        std::sort(items.begin(), items.end(),
+                  [](const DrawItem& a, const DrawItem& b) { return a.distance2 < b.distance2; });
+        for (const DrawItem& item : items) {
+            const ChunkMeshLayout& layout = item.chunk->meshLayout;
+            if (layout.opaqueCount() > 0) pushCommand(item, 0, layout.opaqueCount());
+        }
+        opaqueDraws = commands.size();
+        for (auto it = items.rbegin(); it != items.rend(); ++it) {
+            const ChunkMeshLayout& layout = it->chunk->meshLayout;
+            if (layout.translucentCount() > 0) pushCommand(*it, layout.translucentStart(), layout.translucentCount());
+        }
+    } else {
+        for (const DrawItem& item : items) pushCommand(item, 0, (uint32_t)item.chunk->meshVertexCount);
+        opaqueDraws = commands.size();
+    }
+    if (commands.empty()) return;
+
+    // 每帧重新填充命令、原点与包围盒缓冲，容量不足时按倍数扩容
+    streamBuffer(GL_ARRAY_BUFFER, originBuffer, originCapacity, origins.size() * sizeof(glm::vec4), origins.data());
+    streamBuffer(GL_DRAW_INDIRECT_BUFFER, indirectBuffer, indirectCapacity, commands.size() * sizeof(DrawCommand), commands.data());
+
+    if (occlusion && occlusion->ready() && !geometryChanged) {
+        streamBuffer(GL_SHADER_STORAGE_BUFFER, boundsBuffer, boundsCapacity, bounds.size() * sizeof(glm::vec4), bounds.data());
+        GpuScope gpuScope(gpuTimer, "hi-z cull");
+        occlusion->cull(indirectBuffer, boundsBuffer, (int)commands.size());
+        occlusionTested = true;
+    }
+    occludedDraws = occlusionTested ? occlusion->occludedCount : 0;
+
+    // 读回上上帧的片元统计 (结果还没出来就留着旧值)，本帧用另一个查询对象
+    int slot = fragmentQuerySlot;
+    fragmentQuerySlot ^= 1;
+    if (fragmentQuerySupported) {
+        if (fragmentQueryPending[slot]) {
+            GLint available = 0;
+            glGetQueryObjectiv(fragmentQueries[slot], GL_QUERY_RESULT_AVAILABLE, &available);
+            if (available) {
+                GLuint64 invocations = 0;
+                glGetQueryObjectui64v(fragmentQueries[slot], GL_QUERY_RESULT, &invocations);
+                fragmentInvocations = (long long)invocations;
+            }
+        }
+        glBeginQuery(GL_FRAGMENT_SHADER_INVOCATIONS_ARB, fragmentQueries[slot]);
+        fragmentQueryPending[slot] = true;
+    }
+
+    glBindVertexArray(vao);
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, indirectBuffer);
+    // 确保共享索引缓冲覆盖最大的区块网格 (缓冲 ID 不变，VAO 绑定无需更新)
+    QuadIndexBuffer::reserve(maxQuads);
+    if (sortedPasses) {
+        glDisable(GL_BLEND);
+        {
+            GpuScope gpuScope(gpuTimer, "opaque pass");
+            glMultiDrawElementsIndirect(GL_TRIANGLES, GL_UNSIGNED_INT, (void*)0, (GLsizei)opaqueDraws, 0);
+        }
+        drawCalls++;
+        if (commands.size() > opaqueDraws) {
+            GpuScope gpuScope(gpuTimer, "translucent pass");
+            glEnable(GL_BLEND);
+            glDepthMask(GL_FALSE);
+            glMultiDrawElementsIndirect(GL_TRIANGLES, GL_UNSIGNED_INT, (void*)(opaqueDraws * sizeof(DrawCommand)),
+                                        (GLsizei)(commands.size() - opaqueDraws), 0);
+            glDepthMask(GL_TRUE);
+            drawCalls++;
+        }
+        glEnable(GL_BLEND); // 其余绘制 (选中框、界面) 沿用混合
+    } else {
+        GpuScope gpuScope(gpuTimer, "unsorted pass");
+        glMultiDrawElementsIndirect(GL_TRIANGLES, GL_UNSIGNED_INT, (void*)0, (GLsizei)commands.size(), 0);
+        drawCalls++;
+    }
+    if (fragmentQuerySupported) glEndQuery(GL_FRAGMENT_SHADER_INVOCATIONS_ARB);
+}
@@ -0,0 +1,120 @@
+#pragma once
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include <vector>
+#include "BufferAllocator.hpp"
+#include "HiZCuller.hpp"
+#include "GpuTimer.hpp"
+#include "StagingRing.hpp"
+#include "../World/Chunk.hpp"
+
+// 所有区块网格共用一个大顶点缓冲，每帧把视锥内的区块组装成间接绘制命令，
+// 一次 glMultiDrawElementsIndirect 提交；区块世界偏移作为实例属性 (divisor 1，按 baseInstance 取)
+// 分两遍：不透明的面按区块从近到远、关闭混合 (尽量让远处的片元被提前深度测试拒绝)，
+// 半透明的面 (水) 随后按从远到近混合、不写深度
+class ChunkRenderer {
+public:
+    explicit ChunkRenderer(size_t initialVertices = 1 << 20);
+    ~ChunkRenderer();
+
+    // 上传 chunks 中已就绪的网格 (主线程，在 beginFrame 之后)：新网格按距离从近到远上传，
+    // 本帧写入的字节数达到 uploadBudget 后其余留在区块里下一帧再取；增量重建的切面不受预算限制，
+    // 放得下的只覆盖该切面的区间。顶点先写入持久映射的暂存环，再在 GPU 端拷到大缓冲
+    void uploadChunks(const std::vector<Chunk*>& chunks);
+    // 区块卸载时归还其缓冲区间
+    void release(Chunk& chunk);
+
+    // cameraPos 用于两遍绘制的区块排序
+    void beginFrame(const glm::vec3& cameraPos);
+    void addDraw(Chunk& chunk);
+    // occlusion 非空且金字塔可用时先在 GPU 上做 Hi-Z 遮挡测试；
+    // 本帧有被编辑的区块换上新网格时上一帧的深度不可信，跳过测试
+    void draw(HiZCuller* occlusion = nullptr);
+
+    // 关闭时退回单遍绘制：每个区块一个命令、按提交顺序、始终混合 (用于对比片元着色器调用次数)
+    bool sortedPasses = true;
+    // 每帧上传新网格的字节预算 (至少上传一个最近的区块)；一大批网格同时完成时分摊到后面几帧，避免卡顿
+    size_t uploadBudget = 1 << 20;
+    // 非空时给遮挡测试与各遍绘制计时 (性能分析录制期间)
+    GpuTimer* gpuTimer = nullptr;
+
+    // 统计
+    int drawCalls = 0;      // 本帧实际发出的 draw call 数
+    int drawnChunks = 0;    // 本帧提交的区块数
+    int occludedDraws = 0;  // 被 Hi-Z 剔除的绘制命令数 (不透明 / 半透明各算一个；GPU 结果异步读回，是一两帧前的数字)
+    bool occlusionTested = false; // 本帧是否做了遮挡测试
+    int patchedSlices = 0;  // 本帧原地覆盖的切面数
+    size_t uploadedBytes = 0; // 本帧写入顶点缓冲的字节数
+    int deferredMeshes = 0;   // 本帧超出预算、留到之后上传的网格数
+    int stagingFallbacks = 0; // 暂存环没有空间 (GPU 还没用完之前的拷贝) 而改用 glBufferSubData 的次数，累计
+    // 区块绘制的片元着色器调用次数 (需要 GL_ARB_pipeline_statistics_query，不支持时为 -1；异步读回)
+    long long fragmentInvocations = -1;
+    size_t usedVertices() const { return allocator.used(); }
+    size_t capacityVertices() const { return allocator.capacity(); }
+
+private:
+    // 与 GL 规范中 DrawElementsIndirectCommand 布局一致
+    struct DrawCommand {
+        GLuint count;
+        GLuint instanceCount;
+        GLuint firstIndex;
+        GLint baseVertex;
+        GLuint baseInstance;
+    };
+
+    GLuint vao = 0;
+    GLuint vertexBuffer = 0;
+    GLuint originBuffer = 0;
+    GLuint indirectBuffer = 0;
+    GLuint boundsBuffer = 0;
+    size_t originCapacity = 0;
+    size_t indirectCapacity = 0;
+    size_t boundsCapacity = 0;
+    size_t maxQuads = 0;
+
+    // addDraw 收集的区块，draw 时排序后生成命令
+    struct DrawItem {
+        Chunk* chunk;
+        float distance2;        // 区块中心到相机距离的平方
+        glm::vec4 boundsMin, boundsMax;
+    };
+
+    BufferAllocator allocator;
+    std::vector<DrawItem> items;
+    std::vector<DrawCommand> commands;
+    std::vector<glm::vec4> origins;
+    std::vector<glm::vec4> bounds; // 每个命令两个：min (w = 1 表示刚出现，跳过遮挡测试)、max
+    glm::vec3 cameraPos{0.0f};
+    uint32_t frame = 0;
+
+    // 片元统计查询双缓冲，结果可用时才读取
+    bool fragmentQuerySupported = false;
+    GLuint fragmentQueries[2] = {0, 0};
+    bool fragmentQueryPending[2] = {false, false};
+    int fragmentQuerySlot = 0;
+    bool geometryChanged = false;  // 本帧有被编辑的区块换上了新网格
+    ChunkMesh staging; // 从区块取出的待上传网格，复用容量
+    // 约为预算的十几倍，GPU 落后几帧时仍有空间
+    StagingRing stagingRing{16 << 20};
+    struct PendingUpload {
+        Chunk* chunk;
+        float distance2;
+    };
+    std::vector<PendingUpload> pendingUploads;
+
+    // 取走区块的新网格与切面补丁并写入大缓冲
+    void upload(Chunk& chunk);
+    // 经暂存环写入大缓冲中从 vertexOffset 开始的 count 个顶点
+    void writeVertices(size_t vertexOffset, const Vertex* vertices, size_t count);
+    float distance2(const Chunk& chunk) const;
+
+    // 按切面排布并留出余量，写入 chunk.meshLayout，整块重新分配上传
+    void uploadLayout(Chunk& chunk, const ChunkMesh& mesh);
+    void applyPatch(Chunk& chunk, const SlicePatch& patch);
+    // 生成一个绘制命令 (区块网格中 [first, first + count) 的顶点)
+    void pushCommand(const DrawItem& item, uint32_t first, uint32_t count);
+    void growVertexBuffer(size_t minVertices);
+    void bindVertexBuffer();
+    // 按容量倍增的方式重新填充每帧的流式缓冲
+    static void streamBuffer(GLenum target, GLuint buffer, size_t& capacity, size_t bytes, const void* data);
+};
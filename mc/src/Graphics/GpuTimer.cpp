@@ -0,0 +1,65 @@
+#include "GpuTimer.hpp"
+#include "../Core/Profiler.hpp"
+
+GpuTimer::~GpuTimer() {
+    for (const Span& span : pending) glDeleteQueries(2, span.queries);
+    if (!freeQueries.empty()) glDeleteQueries((GLsizei)freeQueries.size(), freeQueries.data());
+}
+
+GLuint GpuTimer::acquireQuery() {
+    if (freeQueries.empty()) {
+        GLuint query = 0;
+        glGenQueries(1, &query);
+        return query;
+    }
+    GLuint query = freeQueries.back();
+    freeQueries.pop_back();
+    return query;
+}
+
+void GpuTimer::beginFrame() {
+    using namespace std::chrono;
+    auto toCpu = [](GLuint64 gpuTime, nanoseconds offset) {
+        return Profiler::Clock::time_point(duration_cast<Profiler::Clock::duration>(nanoseconds(gpuTime) + offset));
+    };
+    // 按发出顺序回读，遇到第一个还没出结果的就停下 (之后的更不会完成)
+    while (!pending.empty()) {
+        Span& span = pending.front();
+        if (!span.ended) break;
+        GLint available = 0;
+        glGetQueryObjectiv(span.queries[1], GL_QUERY_RESULT_AVAILABLE, &available);
+        if (!available) break;
+        GLuint64 begin = 0, end = 0;
+        glGetQueryObjectui64v(span.queries[0], GL_QUERY_RESULT, &begin);
+        glGetQueryObjectui64v(span.queries[1], GL_QUERY_RESULT, &end);
+        Profiler::get().addGpuSpan(span.name, toCpu(begin, span.offset), toCpu(end, span.offset));
+        freeQueries.push_back(span.queries[0]);
+        freeQueries.push_back(span.queries[1]);
+        pending.pop_front();
+    }
+
+    // GPU 时间戳与 CPU 时钟起点不同，每帧取一次两者的差 (GL_TIMESTAMP 查询的是 GPU 当前时间，不等待之前的命令执行)
+    if (Profiler::get().isCapturing()) {
+        GLint64 gpuNow = 0;
+        glGetInteger64v(GL_TIMESTAMP, &gpuNow);
+        offset = duration_cast<nanoseconds>(Profiler::Clock::now().time_since_epoch()) - nanoseconds(gpuNow);
+    }
+}
+
+int GpuTimer::begin(const char* name) {
+    if (!Profiler::get().isCapturing()) return -1;
+    Span span{nextId++, name, {acquireQuery(), acquireQuery()}, offset, false};
+    glQueryCounter(span.queries[0], GL_TIMESTAMP);
+    pending.push_back(span);
+    return span.id;
+}
+
+void GpuTimer::end(int id) {
+    if (id < 0) return;
+    for (auto it = pending.rbegin(); it != pending.rend(); ++it) {
+        if (it->id != id) continue;
+        glQueryCounter(it->queries[1], GL_TIMESTAMP);
+        it->ended = true;
+        return;
+    }
+}
@@ -0,0 +1,52 @@
+#pragma once
+#include <glad/glad.h>
+#include <chrono>
+#include <deque>
+#include <vector>
+
+// GPU 各遍计时 (GL_TIMESTAMP 查询)，只在 Profiler 录制期间发出查询
+// 结果一般落后一到三帧，每帧开头回读已完成的那些，换算到 CPU 时钟后交给 Profiler 的 GPU 轨道；
+// 不等待未完成的查询，不会让 CPU 停下来等 GPU
+class GpuTimer {
+public:
+    GpuTimer() = default;
+    ~GpuTimer();
+    GpuTimer(const GpuTimer&) = delete;
+    GpuTimer& operator=(const GpuTimer&) = delete;
+
+    // 每帧开头调用：回读已完成的查询，并用当前 GPU 时间戳重新校准两个时钟的差值
+    void beginFrame();
+
+    // 返回的编号交给 end；不在录制时返回 -1，end 忽略
+    int begin(const char* name);
+    void end(int id);
+
+private:
+    struct Span {
+        int id;
+        const char* name;
+        GLuint queries[2];
+        std::chrono::nanoseconds offset; // CPU 时钟 - GPU 时钟
+        bool ended;
+    };
+
+    GLuint acquireQuery();
+
+    std::vector<GLuint> freeQueries;
+    std::deque<Span> pending;   // 按发出顺序，最后一个可能还没 end
+    std::chrono::nanoseconds offset{0};
+    int nextId = 0;
+};
+
+// 作用域形式：构造时 begin，析构时 end；timer 为空时什么都不做
+class GpuScope {
+public:
+    GpuScope(GpuTimer* timer, const char* name) : timer(timer), id(timer ? timer->begin(name) : -1) {}
+    ~GpuScope() { if (timer) timer->end(id); }
+    GpuScope(const GpuScope&) = delete;
+    GpuScope& operator=(const GpuScope&) = delete;
+
+private:
+    GpuTimer* timer;
+    int id;
+};
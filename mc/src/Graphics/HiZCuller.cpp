@@ -0,0 +1,102 @@
+#include "HiZCuller.hpp"
+#include <algorithm>
+
+HiZCuller::HiZCuller(int width, int height, const char* reduceSrc, const char* cullSrc)
+    : width(width), height(height), reduceShader(reduceSrc), cullShader(cullSrc)
+{
+    levels = 1;
+    while ((std::max(width, height) >> levels) > 0) levels++;
+
+    glGenTextures(1, &depthTexture);
+    glBindTexture(GL_TEXTURE_2D, depthTexture);
+    glTexStorage2D(GL_TEXTURE_2D, 1, GL_DEPTH_COMPONENT24, width, height);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+
+    glGenTextures(1, &pyramid);
+    glBindTexture(GL_TEXTURE_2D, pyramid);
+    glTexStorage2D(GL_TEXTURE_2D, levels, GL_R32F, width, height);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST_MIPMAP_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    glGenBuffers(2, counters);
+    for (GLuint counter : counters) {
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, counter);
+        glBufferData(GL_SHADER_STORAGE_BUFFER, sizeof(GLuint), nullptr, GL_DYNAMIC_READ);
+    }
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+}
+
+HiZCuller::~HiZCuller() {
+    for (GLsync fence : fences)
+        if (fence) glDeleteSync(fence);
+    glDeleteBuffers(2, counters);
+    glDeleteTextures(1, &depthTexture);
+    glDeleteTextures(1, &pyramid);
+}
+
+void HiZCuller::build(const glm::mat4& viewProj) {
+    glBindTexture(GL_TEXTURE_2D, depthTexture);
+    glCopyTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, 0, 0, width, height);
+
+    // 第 0 级从深度纹理 1:1 拷贝，之后每级从上一级取最大值
+    reduceShader.use();
+    reduceShader.setInt("src", 0);
+    glActiveTexture(GL_TEXTURE0);
+    glm::ivec2 srcSize(width, height);
+    for (int level = 0; level < levels; ++level) {
+        glm::ivec2 dstSize = level == 0 ? srcSize : glm::max(srcSize / 2, glm::ivec2(1));
+        glBindTexture(GL_TEXTURE_2D, level == 0 ? depthTexture : pyramid);
+        glBindImageTexture(0, pyramid, level, GL_FALSE, 0, GL_WRITE_ONLY, GL_R32F);
+        reduceShader.setInt("copyLevel", level == 0);
+        reduceShader.setInt("srcLevel", std::max(level - 1, 0));
+        reduceShader.setIVec2("srcSize", srcSize);
+        reduceShader.setIVec2("dstSize", dstSize);
+        reduceShader.dispatch(dstSize.x, dstSize.y, 8, 8);
+        glMemoryBarrier(GL_TEXTURE_FETCH_BARRIER_BIT | GL_SHADER_IMAGE_ACCESS_BARRIER_BIT);
+        srcSize = dstSize;
+    }
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    pyramidViewProj = viewProj;
+    valid = true;
+}
+
+void HiZCuller::cull(GLuint commandBuffer, GLuint boundsBuffer, int count) {
+    // 读回上上次的计数；GPU 还没写完就跳过，不等待
+    int slot = counterSlot;
+    counterSlot ^= 1;
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, counters[slot]);
+    if (fences[slot]) {
+        if (glClientWaitSync(fences[slot], 0, 0) != GL_TIMEOUT_EXPIRED) {
+            GLuint visible = 0;
+            glGetBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, sizeof(GLuint), &visible);
+            occludedCount = testedCounts[slot] - (int)visible;
+        }
+        glDeleteSync(fences[slot]);
+        fences[slot] = nullptr;
+    }
+    const GLuint zero = 0;
+    glBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, sizeof(GLuint), &zero);
+    testedCounts[slot] = count;
+
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, commandBuffer);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, boundsBuffer);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 2, counters[slot]);
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, pyramid);
+
+    cullShader.use();
+    cullShader.setInt("hiz", 0);
+    cullShader.setMat4("viewProj", pyramidViewProj);
+    cullShader.setIVec2("screenSize", glm::ivec2(width, height));
+    cullShader.setInt("maxLevel", levels - 1);
+    cullShader.setInt("drawCount", count);
+    cullShader.dispatch(count, 1, 64);
+
+    // 间接绘制读命令缓冲、下次读回计数都要看到着色器的写入
+    glMemoryBarrier(GL_COMMAND_BARRIER_BIT | GL_BUFFER_UPDATE_BARRIER_BIT);
+    fences[slot] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    glBindTexture(GL_TEXTURE_2D, 0);
+}
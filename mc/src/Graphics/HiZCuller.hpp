@@ -0,0 +1,44 @@
+#pragma once
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include "Shader.hpp"
+
+// Hi-Z 遮挡剔除
+// 每帧画完区块后把深度缓冲拷出来，逐级取 2x2 最大值 (最远深度) 建成金字塔；
+// 下一帧绘制前由计算着色器把每个区块的包围盒投影到金字塔上 (用建金字塔那一帧的矩阵，与深度一致)，
+// 包围盒最近点比覆盖区域内最远的深度还远就是被挡住了，把对应间接绘制命令的 instanceCount 置 0
+class HiZCuller {
+public:
+    // 源码由调用方读入：hiz_reduce.cs 建金字塔，chunk_cull.cs 做测试
+    HiZCuller(int width, int height, const char* reduceSrc, const char* cullSrc);
+    ~HiZCuller();
+
+    // 画完区块后调用：从当前读帧缓冲拷贝深度并建金字塔，记录这一帧的 viewProj
+    void build(const glm::mat4& viewProj);
+    // 金字塔作废 (关闭剔除后)，下次 build 之前不做测试
+    void invalidate() { valid = false; }
+    bool ready() const { return valid; }
+
+    // 测试 commandBuffer 中的 count 个绘制命令 (DrawElementsIndirectCommand)，
+    // boundsBuffer 每个命令两个 vec4：min (w != 0 表示跳过测试、直接可见)、max
+    // 结束时已插入内存屏障，可直接用于间接绘制
+    void cull(GLuint commandBuffer, GLuint boundsBuffer, int count);
+
+    // 被剔除的命令数 (异步读回，是一两帧前那次测试的结果)
+    int occludedCount = 0;
+
+private:
+    int width, height, levels;
+    GLuint depthTexture = 0;   // 深度缓冲的拷贝
+    GLuint pyramid = 0;        // R32F，含完整 mip 链，第 0 级与屏幕同尺寸
+    Shader reduceShader;
+    Shader cullShader;
+    glm::mat4 pyramidViewProj{1.0f};
+    bool valid = false;
+
+    // 可见计数双缓冲：写一个、读上一帧的另一个，用 fence 判断 GPU 是否写完，避免同步等待
+    GLuint counters[2] = {0, 0};
+    GLsync fences[2] = {nullptr, nullptr};
+    int testedCounts[2] = {0, 0};
+    int counterSlot = 0;
+};
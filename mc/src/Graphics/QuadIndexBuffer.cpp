@@ -0,0 +1,28 @@
+#include "QuadIndexBuffer.hpp"
+#include <vector>
+#include <cstdint>
+
+GLuint QuadIndexBuffer::ebo = 0;
+size_t QuadIndexBuffer::capacity = 0;
+
+GLuint QuadIndexBuffer::reserve(size_t quadCount) {
+    if (ebo == 0) glGenBuffers(1, &ebo);
+    if (quadCount <= capacity) return ebo;
+
+    size_t newCapacity = capacity ? capacity : 16384;
+    while (newCapacity < quadCount) newCapacity *= 2;
+
+    std::vector<uint32_t> indices(newCapacity * 6);
+    for (size_t q = 0; q < newCapacity; ++q) {
+        uint32_t base = (uint32_t)(q * 4);
+        uint32_t* dst = &indices[q * 6];
+        dst[0] = base; dst[1] = base + 1; dst[2] = base + 2;
+        dst[3] = base + 2; dst[4] = base + 3; dst[5] = base;
+    }
+    // 用 COPY_WRITE 目标上传，避免改动当前绑定 VAO 的索引缓冲
+    glBindBuffer(GL_COPY_WRITE_BUFFER, ebo);
+    glBufferData(GL_COPY_WRITE_BUFFER, indices.size() * sizeof(uint32_t), indices.data(), GL_STATIC_DRAW);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+    capacity = newCapacity;
+    return ebo;
+}
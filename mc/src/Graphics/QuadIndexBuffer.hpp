@@ -0,0 +1,15 @@
+#pragma once
+#include <glad/glad.h>
+#include <cstddef>
+
+// 所有区块共享的静态四边形索引缓冲
+// 每个四边形 4 个顶点，索引模式 0,1,2, 2,3,0；区块网格只需上传顶点
+class QuadIndexBuffer {
+public:
+    // 确保能容纳 quadCount 个四边形 (不足时按倍数扩容，缓冲 ID 不变)，返回缓冲 ID
+    static GLuint reserve(size_t quadCount);
+
+private:
+    static GLuint ebo;
+    static size_t capacity;
+};
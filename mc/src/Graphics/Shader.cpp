@@ -14,11 +14,32 @@ Shader::Shader(const char* vSrc, const char* fSrc) {
     glDeleteShader(f);
 }
 
+Shader::Shader(const char* cSrc) {
+    GLuint c = compile(GL_COMPUTE_SHADER, cSrc);
+    ID = glCreateProgram();
+    glAttachShader(ID, c);
+    glLinkProgram(ID);
+    glDeleteShader(c);
+}
+
 Shader::~Shader() { glDeleteProgram(ID); }
 void Shader::use() const { glUseProgram(ID); }
+void Shader::dispatch(int x, int y, int localSizeX, int localSizeY) const {
+    glDispatchCompute((x + localSizeX - 1) / localSizeX, (y + localSizeY - 1) / localSizeY, 1);
+}
 void Shader::setMat4(const std::string& name, const glm::mat4& mat) const {
     glUniformMatrix4fv(glGetUniformLocation(ID, name.c_str()), 1, GL_FALSE, glm::value_ptr(mat));
 }
+void Shader::setVec3(const std::string& name, const glm::vec3& vec) const {
+    glUniform3f(glGetUniformLocation(ID, name.c_str()), vec.x, vec.y, vec.z);
+}
+
+void Shader::setInt(const std::string& name, int value) const {
+    glUniform1i(glGetUniformLocation(ID, name.c_str()), value);
+}
+void Shader::setIVec2(const std::string& name, const glm::ivec2& vec) const {
+    glUniform2i(glGetUniformLocation(ID, name.c_str()), vec.x, vec.y);
+}
 
 GLuint Shader::compile(GLenum type, const char* src) {
     GLuint s = glCreateShader(type);
@@ -8,9 +8,16 @@ class Shader {
 public:
     GLuint ID;
     Shader(const char* vertexSrc, const char* fragmentSrc);
+    // 计算着色器
+    explicit Shader(const char* computeSrc);
     ~Shader();
     void use() const;
+    // 以 localSize 为工作组大小覆盖 (x, y) 个调用，需先 use()
+    void dispatch(int x, int y, int localSizeX, int localSizeY = 1) const;
     void setMat4(const std::string& name, const glm::mat4& mat) const;
+    void setVec3(const std::string& name, const glm::vec3& vec) const;
+    void setInt(const std::string& name, int value) const;
+    void setIVec2(const std::string& name, const glm::ivec2& vec) const;
 private:
     GLuint compile(GLenum type, const char* source);
 };
\ No newline at end of file
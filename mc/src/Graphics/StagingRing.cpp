@@ -0,0 +1,51 @@
+#include "StagingRing.hpp"
+
+StagingRing::StagingRing(size_t capacity) : size(capacity) {
+    const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+    glGenBuffers(1, &ringBuffer);
+    glBindBuffer(GL_COPY_READ_BUFFER, ringBuffer);
+    glBufferStorage(GL_COPY_READ_BUFFER, size, nullptr, flags);
+    mapped = static_cast<uint8_t*>(glMapBufferRange(GL_COPY_READ_BUFFER, 0, size, flags));
+}
+
+StagingRing::~StagingRing() {
+    for (const Segment& s : segments) glDeleteSync(s.fence);
+    glBindBuffer(GL_COPY_READ_BUFFER, ringBuffer);
+    glUnmapBuffer(GL_COPY_READ_BUFFER);
+    glDeleteBuffers(1, &ringBuffer);
+}
+
+void StagingRing::retire() {
+    while (!segments.empty() && glClientWaitSync(segments.front().fence, 0, 0) != GL_TIMEOUT_EXPIRED) {
+        glDeleteSync(segments.front().fence);
+        used -= segments.front().bytes;
+        segments.pop_front();
+    }
+}
+
+uint8_t* StagingRing::allocate(size_t bytes, size_t& offset) {
+    if (!mapped) return nullptr;
+    bytes = (bytes + 15) & ~(size_t)15;
+    retire();
+    if (used == 0) head = 0; // 全部空闲时从头开始，减少绕回
+    if (head + bytes > size) {
+        // 尾部放不下：跳过尾部从 0 开始，跳过的部分随本帧一起归还
+        size_t skip = size - head;
+        if (used + skip + bytes > size) return nullptr;
+        used += skip;
+        frameBytes += skip;
+        head = 0;
+    }
+    if (used + bytes > size) return nullptr;
+    offset = head;
+    head += bytes;
+    used += bytes;
+    frameBytes += bytes;
+    return mapped + offset;
+}
+
+void StagingRing::endFrame() {
+    if (frameBytes == 0) return;
+    segments.push_back({glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0), frameBytes});
+    frameBytes = 0;
+}
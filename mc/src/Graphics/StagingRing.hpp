@@ -0,0 +1,43 @@
+#pragma once
+#include <glad/glad.h>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+
+// 上传用的环形暂存缓冲：持久映射 (glBufferStorage + PERSISTENT | COHERENT)，CPU 直接写入映射内存，
+// 再由 glCopyBufferSubData 在 GPU 端拷到目标缓冲，不经过驱动的 glBufferSubData 临时拷贝
+// 每帧写入的区间在 endFrame 时插入 fence，GPU 执行完这一帧的拷贝之后才会被重新分配；
+// 空间不够时 allocate 直接失败，从不等待 GPU
+class StagingRing {
+public:
+    explicit StagingRing(size_t capacity);
+    ~StagingRing();
+    StagingRing(const StagingRing&) = delete;
+    StagingRing& operator=(const StagingRing&) = delete;
+
+    // 分配 bytes 字节 (按 16 字节对齐)，返回映射地址，offset 为在 buffer() 中的偏移；空间仍被 GPU 占用时返回 nullptr
+    uint8_t* allocate(size_t bytes, size_t& offset);
+    // 本帧的拷贝命令都已发出后调用
+    void endFrame();
+
+    GLuint buffer() const { return ringBuffer; }
+    size_t capacity() const { return size; }
+    size_t inFlightBytes() const { return used; } // 含本帧已分配、尚未确认 GPU 用完的字节
+
+private:
+    // 一帧分配的字节数 (含绕回时跳过的尾部)，fence 触发后整段归还
+    struct Segment {
+        GLsync fence;
+        size_t bytes;
+    };
+
+    void retire();
+
+    GLuint ringBuffer = 0;
+    uint8_t* mapped = nullptr;
+    size_t size;
+    size_t head = 0;       // 下一次分配的位置
+    size_t used = 0;       // [tail, head) 的长度 (环形)，tail 隐含为 head - used
+    size_t frameBytes = 0; // 本帧分配的字节数
+    std::deque<Segment> segments;
+};
@@ -1,6 +1,44 @@
 // Frustum.cpp
 #include "Frustum.hpp"
 
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define MC_FRUSTUM_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#endif
+
+#if defined(MC_FRUSTUM_X86) && (defined(__GNUC__) || defined(__clang__))
+#define MC_TARGET(t) __attribute__((target(t)))
+#else
+#define MC_TARGET(t)
+#endif
+
+void AABBList::set(int i, const AABB& box) {
+    minX[i] = box.min.x; minY[i] = box.min.y; minZ[i] = box.min.z;
+    maxX[i] = box.max.x; maxY[i] = box.max.y; maxZ[i] = box.max.z;
+}
+
+void AABBList::push(const AABB& box) {
+    if (count == (int)minX.size()) {
+        // 按批扩容，补齐部分的内容不影响结果 (testBoxes 会屏蔽掉)
+        size_t n = minX.size() + BATCH;
+        for (auto* v : {&minX, &minY, &minZ, &maxX, &maxY, &maxZ}) v->resize(n, 0.0f);
+    }
+    set(count++, box);
+}
+
+void AABBList::removeSwap(int i) {
+    --count;
+    if (i != count) set(i, get(count));
+}
+
+void AABBList::clear() {
+    count = 0;
+    for (auto* v : {&minX, &minY, &minZ, &maxX, &maxY, &maxZ}) v->clear();
+}
+
 void Frustum::update(const glm::mat4& viewProj) {
     const float* m = (const float*)&viewProj[0][0];
     auto set = [&](int i, float a, float b, float c, float d) {
@@ -28,4 +66,108 @@ bool Frustum::isBoxVisible(const AABB& box) const {
         if (glm::dot(p.normal, positive) + p.distance < 0) return false;
     }
     return true;
-}
\ No newline at end of file
+}
+
+Frustum::Containment Frustum::classifyBox(const AABB& box) const {
+    bool inside = true;
+    for (const auto& p : planes) {
+        // 沿法线最远的角 (positive) 在外侧 -> 整个盒子在外；最近的角 (negative) 在外侧 -> 与平面相交
+        glm::vec3 positive = box.min, negative = box.max;
+        if (p.normal.x >= 0) { positive.x = box.max.x; negative.x = box.min.x; }
+        if (p.normal.y >= 0) { positive.y = box.max.y; negative.y = box.min.y; }
+        if (p.normal.z >= 0) { positive.z = box.max.z; negative.z = box.min.z; }
+
+        if (glm::dot(p.normal, positive) + p.distance < 0) return Containment::Outside;
+        if (glm::dot(p.normal, negative) + p.distance < 0) inside = false;
+    }
+    return inside ? Containment::Inside : Containment::Intersecting;
+}
+
+namespace {
+
+// 每个平面按法线符号选出 positive 角所在的数组，两种实现共用
+struct PlaneBoxes {
+    const float* x[6];
+    const float* y[6];
+    const float* z[6];
+
+    PlaneBoxes(const std::array<Frustum::Plane, 6>& planes, const AABBList& boxes) {
+        for (int i = 0; i < 6; ++i) {
+            x[i] = planes[i].normal.x >= 0 ? boxes.maxX.data() : boxes.minX.data();
+            y[i] = planes[i].normal.y >= 0 ? boxes.maxY.data() : boxes.minY.data();
+            z[i] = planes[i].normal.z >= 0 ? boxes.maxZ.data() : boxes.minZ.data();
+        }
+    }
+};
+
+void testBoxesScalar(const std::array<Frustum::Plane, 6>& planes, const PlaneBoxes& pb, int batches, uint8_t* masks) {
+    for (int b = 0; b < batches; ++b) {
+        uint8_t mask = 0;
+        for (int k = 0; k < AABBList::BATCH; ++k) {
+            int i = b * AABBList::BATCH + k;
+            bool visible = true;
+            for (int p = 0; p < 6 && visible; ++p) {
+                const Frustum::Plane& pl = planes[p];
+                visible = pl.normal.x * pb.x[p][i] + pl.normal.y * pb.y[p][i] + pl.normal.z * pb.z[p][i] + pl.distance >= 0;
+            }
+            mask |= (uint8_t)visible << k;
+        }
+        masks[b] = mask;
+    }
+}
+
+#ifdef MC_FRUSTUM_X86
+MC_TARGET("avx")
+void testBoxesAvx(const std::array<Frustum::Plane, 6>& planes, const PlaneBoxes& pb, int batches, uint8_t* masks) {
+    __m256 nx[6], ny[6], nz[6], d[6];
+    for (int p = 0; p < 6; ++p) {
+        nx[p] = _mm256_set1_ps(planes[p].normal.x);
+        ny[p] = _mm256_set1_ps(planes[p].normal.y);
+        nz[p] = _mm256_set1_ps(planes[p].normal.z);
+        d[p] = _mm256_set1_ps(planes[p].distance);
+    }
+    const __m256 zero = _mm256_setzero_ps();
+    for (int b = 0; b < batches; ++b) {
+        const int i = b * AABBList::BATCH;
+        // 不用 FMA，保证与标量版逐位一致
+        __m256 visible = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+        for (int p = 0; p < 6; ++p) {
+            __m256 dist = _mm256_add_ps(_mm256_add_ps(_mm256_add_ps(
+                _mm256_mul_ps(nx[p], _mm256_loadu_ps(pb.x[p] + i)),
+                _mm256_mul_ps(ny[p], _mm256_loadu_ps(pb.y[p] + i))),
+                _mm256_mul_ps(nz[p], _mm256_loadu_ps(pb.z[p] + i))), d[p]);
+            visible = _mm256_and_ps(visible, _mm256_cmp_ps(dist, zero, _CMP_GE_OQ));
+        }
+        masks[b] = (uint8_t)_mm256_movemask_ps(visible);
+    }
+}
+
+bool cpuHasAvx() {
+#if defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 1);
+    bool osxsave = (info[2] & (1 << 27)) != 0, avx = (info[2] & (1 << 28)) != 0;
+    return osxsave && avx && (_xgetbv(0) & 6) == 6;
+#else
+    return __builtin_cpu_supports("avx");
+#endif
+}
+#endif
+
+} // namespace
+
+void Frustum::testBoxes(const AABBList& boxes, uint8_t* masks) const {
+    const int batches = boxes.batches();
+    if (batches == 0) return;
+    PlaneBoxes pb(planes, boxes);
+#ifdef MC_FRUSTUM_X86
+    static const bool avx = cpuHasAvx();
+    if (avx) testBoxesAvx(planes, pb, batches, masks);
+    else testBoxesScalar(planes, pb, batches, masks);
+#else
+    testBoxesScalar(planes, pb, batches, masks);
+#endif
+    // 最后一批中补齐的位置不算
+    int tail = boxes.count % AABBList::BATCH;
+    if (tail) masks[batches - 1] &= (uint8_t)((1u << tail) - 1);
+}
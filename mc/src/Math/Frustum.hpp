@@ -2,17 +2,41 @@
 #pragma once
 #include <glm/glm.hpp>
 #include <array>
+#include <cstdint>
+#include <vector>
 
 struct AABB {
     glm::vec3 min;
     glm::vec3 max;
 };
 
+// 结构数组 (SoA) 形式的一组包围盒，供 Frustum::testBoxes 每 8 个一批测试
+struct AABBList {
+    static constexpr int BATCH = 8;
+    std::vector<float> minX, minY, minZ, maxX, maxY, maxZ; // 长度补齐到 BATCH 的倍数
+    int count = 0;
+
+    int batches() const { return (count + BATCH - 1) / BATCH; }
+    AABB get(int i) const { return {{minX[i], minY[i], minZ[i]}, {maxX[i], maxY[i], maxZ[i]}}; }
+    void set(int i, const AABB& box);
+    void push(const AABB& box);
+    // 用最后一个盒子填补第 i 个 (顺序会变)
+    void removeSwap(int i);
+    void clear();
+};
+
 class Frustum {
 public:
     struct Plane { glm::vec3 normal; float distance; };
     std::array<Plane, 6> planes;
 
+    enum class Containment { Outside, Intersecting, Inside };
+
     void update(const glm::mat4& viewProj);
     bool isBoxVisible(const AABB& box) const;
-};
\ No newline at end of file
+    // 完全在外 / 与边界相交 / 完全在内 (分组剔除用：整组在内时组内的盒子不必再测)
+    Containment classifyBox(const AABB& box) const;
+    // 批量测试：masks[b] 的第 i 位表示第 b * 8 + i 个盒子可见 (与 isBoxVisible 结果相同)，
+    // 共 boxes.batches() 个；CPU 支持时用 AVX 一次测 8 个
+    void testBoxes(const AABBList& boxes, uint8_t* masks) const;
+};
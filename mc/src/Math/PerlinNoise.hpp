@@ -14,6 +14,17 @@ public:
     // octaves: 叠加层数, persistence: 振幅衰减, lacunarity: 频率增长
     double fbm(double x, double y, double z, int octaves, double persistence, double lacunarity) const;
 
+    // 批量 fbm：在 y 固定的平面上一次算一整块网格 (例如区块的 32x32 高度图)
+    //   out[j * stride + i] = fbm(x0 + i * dx, y, z0 + j * dz, ...)，0 <= i < countX, 0 <= j < countZ
+    // 沿 x 方向用 float 通道并行 (AVX2 8 路 / SSE4.1 4 路，运行时检测，否则走标量)，
+    // 与 fbm 的结果相差在 1e-4 以内
+    void fbmGrid(float* out, int countX, int countZ, int stride,
+                 double x0, double z0, double dx, double dz, double y,
+                 int octaves, double persistence, double lacunarity) const;
+
+    // 当前 CPU 上 fbmGrid 实际使用的实现 ("avx2" / "sse4.1" / "scalar")
+    static const char* batchBackend();
+
 private:
     std::vector<int> p; // 置换表 (Permutation Table)
     
@@ -0,0 +1,310 @@
+// PerlinNoise::fbmGrid 的批量实现
+// 同一套算法按通道宽度实例化三次：标量 / SSE4.1 / AVX2，运行时按 CPU 支持选择
+#include "PerlinNoise.hpp"
+#include <cmath>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define MC_NOISE_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#endif
+
+#if defined(MC_NOISE_X86) && (defined(__GNUC__) || defined(__clang__))
+#define MC_TARGET(t) __attribute__((target(t)))
+#else
+#define MC_TARGET(t)
+#endif
+
+namespace {
+
+// 每个八度、每一行共享的标量部分：y/z 方向的晶格坐标与插值权重
+struct RowParams {
+    int Y, Z;           // 晶格坐标 (& 255)
+    float y, z;         // 晶格内相对坐标
+    float v, w;         // fade(y), fade(z)
+    int xBase;          // 行起点的整数部分 (保留 double 精度，避免大坐标下 float 丢精度)
+    float xFrac;        // 行起点的小数部分
+    float xStep;        // 相邻通道的间距
+};
+
+inline float fadeScalar(float t) { return t * t * t * (t * (t * 6 - 15) + 10); }
+
+// ---------------- 标量 ----------------
+struct ScalarLanes {
+    static constexpr int N = 1;
+
+    static float gradS(int hash, float x, float y, float z) {
+        int h = hash & 15;
+        float u = h < 8 ? x : y;
+        float v = h < 4 ? y : (h == 12 || h == 14 ? x : z);
+        return ((h & 1) ? -u : u) + ((h & 2) ? -v : v);
+    }
+
+    static void noise(const int* p, const RowParams& r, int lane0, float* out) {
+        float fx = r.xFrac + r.xStep * lane0;
+        float fl = std::floor(fx);
+        int X = (r.xBase + (int)fl) & 255;
+        float x = fx - fl;
+        float u = fadeScalar(x);
+        float y = r.y, z = r.z;
+
+        int A = p[X] + r.Y, AA = p[A] + r.Z, AB = p[A + 1] + r.Z;
+        int B = p[X + 1] + r.Y, BA = p[B] + r.Z, BB = p[B + 1] + r.Z;
+        auto lerp = [](float t, float a, float b) { return a + t * (b - a); };
+        *out = lerp(r.w, lerp(r.v, lerp(u, gradS(p[AA], x, y, z),         gradS(p[BA], x - 1, y, z)),
+                                   lerp(u, gradS(p[AB], x, y - 1, z),     gradS(p[BB], x - 1, y - 1, z))),
+                         lerp(r.v, lerp(u, gradS(p[AA + 1], x, y, z - 1), gradS(p[BA + 1], x - 1, y, z - 1)),
+                                   lerp(u, gradS(p[AB + 1], x, y - 1, z - 1), gradS(p[BB + 1], x - 1, y - 1, z - 1))));
+    }
+};
+
+#ifdef MC_NOISE_X86
+// ---------------- SSE4.1 (4 路) ----------------
+struct SseLanes {
+    static constexpr int N = 4;
+
+    // 无 gather 指令：逐通道查表
+    MC_TARGET("sse4.1") static __m128i lookup(const int* p, __m128i idx) {
+        alignas(16) int i[4];
+        _mm_store_si128((__m128i*)i, idx);
+        return _mm_setr_epi32(p[i[0]], p[i[1]], p[i[2]], p[i[3]]);
+    }
+
+    // 无分支 grad：用比较掩码在 x/y/z 之间选择
+    MC_TARGET("sse4.1") static __m128 grad(__m128i hash, __m128 x, __m128 y, __m128 z) {
+        __m128i h = _mm_and_si128(hash, _mm_set1_epi32(15));
+        __m128 hLt8 = _mm_castsi128_ps(_mm_cmplt_epi32(h, _mm_set1_epi32(8)));
+        __m128 hLt4 = _mm_castsi128_ps(_mm_cmplt_epi32(h, _mm_set1_epi32(4)));
+        __m128 h12or14 = _mm_castsi128_ps(_mm_or_si128(_mm_cmpeq_epi32(h, _mm_set1_epi32(12)),
+                                                       _mm_cmpeq_epi32(h, _mm_set1_epi32(14))));
+        __m128 u = _mm_blendv_ps(y, x, hLt8);
+        __m128 v = _mm_blendv_ps(_mm_blendv_ps(z, x, h12or14), y, hLt4);
+        // 把 h 的 bit0 / bit1 移到符号位后异或，实现条件取反
+        __m128 signU = _mm_castsi128_ps(_mm_slli_epi32(h, 31));
+        __m128 signV = _mm_castsi128_ps(_mm_slli_epi32(_mm_srli_epi32(h, 1), 31));
+        return _mm_add_ps(_mm_xor_ps(u, signU), _mm_xor_ps(v, signV));
+    }
+
+    MC_TARGET("sse4.1") static __m128 lerp(__m128 t, __m128 a, __m128 b) {
+        return _mm_add_ps(a, _mm_mul_ps(t, _mm_sub_ps(b, a)));
+    }
+
+    MC_TARGET("sse4.1") static __m128 fade(__m128 t) {
+        __m128 inner = _mm_add_ps(_mm_mul_ps(t, _mm_sub_ps(_mm_mul_ps(t, _mm_set1_ps(6.0f)), _mm_set1_ps(15.0f))), _mm_set1_ps(10.0f));
+        return _mm_mul_ps(_mm_mul_ps(_mm_mul_ps(t, t), t), inner);
+    }
+
+    MC_TARGET("sse4.1") static void noise(const int* p, const RowParams& r, int lane0, float* out) {
+        __m128 lanes = _mm_setr_ps(0.0f, 1.0f, 2.0f, 3.0f);
+        __m128 fx = _mm_add_ps(_mm_set1_ps(r.xFrac), _mm_mul_ps(_mm_set1_ps(r.xStep), _mm_add_ps(lanes, _mm_set1_ps((float)lane0))));
+        __m128 fl = _mm_floor_ps(fx);
+        __m128i mask = _mm_set1_epi32(255);
+        __m128i X = _mm_and_si128(_mm_add_epi32(_mm_set1_epi32(r.xBase), _mm_cvtps_epi32(fl)), mask);
+        __m128 x = _mm_sub_ps(fx, fl);
+        __m128 u = fade(x);
+        __m128 y = _mm_set1_ps(r.y), z = _mm_set1_ps(r.z);
+        __m128 v = _mm_set1_ps(r.v), w = _mm_set1_ps(r.w);
+        __m128i Y = _mm_set1_epi32(r.Y), Z = _mm_set1_epi32(r.Z), one = _mm_set1_epi32(1);
+
+        __m128i A = _mm_add_epi32(lookup(p, X), Y);
+        __m128i AA = _mm_add_epi32(lookup(p, A), Z);
+        __m128i AB = _mm_add_epi32(lookup(p, _mm_add_epi32(A, one)), Z);
+        __m128i B = _mm_add_epi32(lookup(p, _mm_add_epi32(X, one)), Y);
+        __m128i BA = _mm_add_epi32(lookup(p, B), Z);
+        __m128i BB = _mm_add_epi32(lookup(p, _mm_add_epi32(B, one)), Z);
+
+        __m128 x1 = _mm_sub_ps(x, _mm_set1_ps(1.0f));
+        __m128 y1 = _mm_sub_ps(y, _mm_set1_ps(1.0f));
+        __m128 z1 = _mm_sub_ps(z, _mm_set1_ps(1.0f));
+
+        __m128 r0 = lerp(v, lerp(u, grad(lookup(p, AA), x, y, z),  grad(lookup(p, BA), x1, y, z)),
+                            lerp(u, grad(lookup(p, AB), x, y1, z), grad(lookup(p, BB), x1, y1, z)));
+        __m128 r1 = lerp(v, lerp(u, grad(lookup(p, _mm_add_epi32(AA, one)), x, y, z1),  grad(lookup(p, _mm_add_epi32(BA, one)), x1, y, z1)),
+                            lerp(u, grad(lookup(p, _mm_add_epi32(AB, one)), x, y1, z1), grad(lookup(p, _mm_add_epi32(BB, one)), x1, y1, z1)));
+        _mm_storeu_ps(out, lerp(w, r0, r1));
+    }
+};
+
+// ---------------- AVX2 (8 路) ----------------
+struct AvxLanes {
+    static constexpr int N = 8;
+
+    MC_TARGET("avx2") static __m256i lookup(const int* p, __m256i idx) {
+        return _mm256_i32gather_epi32(p, idx, 4);
+    }
+
+    MC_TARGET("avx2") static __m256 grad(__m256i hash, __m256 x, __m256 y, __m256 z) {
+        __m256i h = _mm256_and_si256(hash, _mm256_set1_epi32(15));
+        __m256 hLt8 = _mm256_castsi256_ps(_mm256_cmpgt_epi32(_mm256_set1_epi32(8), h));
+        __m256 hLt4 = _mm256_castsi256_ps(_mm256_cmpgt_epi32(_mm256_set1_epi32(4), h));
+        __m256 h12or14 = _mm256_castsi256_ps(_mm256_or_si256(_mm256_cmpeq_epi32(h, _mm256_set1_epi32(12)),
+                                                             _mm256_cmpeq_epi32(h, _mm256_set1_epi32(14))));
+        __m256 u = _mm256_blendv_ps(y, x, hLt8);
+        __m256 v = _mm256_blendv_ps(_mm256_blendv_ps(z, x, h12or14), y, hLt4);
+        __m256 signU = _mm256_castsi256_ps(_mm256_slli_epi32(h, 31));
+        __m256 signV = _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_srli_epi32(h, 1), 31));
+        return _mm256_add_ps(_mm256_xor_ps(u, signU), _mm256_xor_ps(v, signV));
+    }
+
+    MC_TARGET("avx2") static __m256 lerp(__m256 t, __m256 a, __m256 b) {
+        return _mm256_add_ps(a, _mm256_mul_ps(t, _mm256_sub_ps(b, a)));
+    }
+
+    MC_TARGET("avx2") static __m256 fade(__m256 t) {
+        __m256 inner = _mm256_add_ps(_mm256_mul_ps(t, _mm256_sub_ps(_mm256_mul_ps(t, _mm256_set1_ps(6.0f)), _mm256_set1_ps(15.0f))), _mm256_set1_ps(10.0f));
+        return _mm256_mul_ps(_mm256_mul_ps(_mm256_mul_ps(t, t), t), inner);
+    }
+
+    MC_TARGET("avx2") static void noise(const int* p, const RowParams& r, int lane0, float* out) {
+        __m256 lanes = _mm256_setr_ps(0.0f, 1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f);
+        __m256 fx = _mm256_add_ps(_mm256_set1_ps(r.xFrac), _mm256_mul_ps(_mm256_set1_ps(r.xStep), _mm256_add_ps(lanes, _mm256_set1_ps((float)lane0))));
+        __m256 fl = _mm256_floor_ps(fx);
+        __m256i mask = _mm256_set1_epi32(255);
+        __m256i X = _mm256_and_si256(_mm256_add_epi32(_mm256_set1_epi32(r.xBase), _mm256_cvtps_epi32(fl)), mask);
+        __m256 x = _mm256_sub_ps(fx, fl);
+        __m256 u = fade(x);
+        __m256 y = _mm256_set1_ps(r.y), z = _mm256_set1_ps(r.z);
+        __m256 v = _mm256_set1_ps(r.v), w = _mm256_set1_ps(r.w);
+        __m256i Y = _mm256_set1_epi32(r.Y), Z = _mm256_set1_epi32(r.Z), one = _mm256_set1_epi32(1);
+
+        __m256i A = _mm256_add_epi32(lookup(p, X), Y);
+        __m256i AA = _mm256_add_epi32(lookup(p, A), Z);
+        __m256i AB = _mm256_add_epi32(lookup(p, _mm256_add_epi32(A, one)), Z);
+        __m256i B = _mm256_add_epi32(lookup(p, _mm256_add_epi32(X, one)), Y);
+        __m256i BA = _mm256_add_epi32(lookup(p, B), Z);
+        __m256i BB = _mm256_add_epi32(lookup(p, _mm256_add_epi32(B, one)), Z);
+
+        __m256 x1 = _mm256_sub_ps(x, _mm256_set1_ps(1.0f));
+        __m256 y1 = _mm256_sub_ps(y, _mm256_set1_ps(1.0f));
+        __m256 z1 = _mm256_sub_ps(z, _mm256_set1_ps(1.0f));
+
+        __m256 r0 = lerp(v, lerp(u, grad(lookup(p, AA), x, y, z),  grad(lookup(p, BA), x1, y, z)),
+                            lerp(u, grad(lookup(p, AB), x, y1, z), grad(lookup(p, BB), x1, y1, z)));
+        __m256 r1 = lerp(v, lerp(u, grad(lookup(p, _mm256_add_epi32(AA, one)), x, y, z1),  grad(lookup(p, _mm256_add_epi32(BA, one)), x1, y, z1)),
+                            lerp(u, grad(lookup(p, _mm256_add_epi32(AB, one)), x, y1, z1), grad(lookup(p, _mm256_add_epi32(BB, one)), x1, y1, z1)));
+        _mm256_storeu_ps(out, lerp(w, r0, r1));
+    }
+};
+
+bool cpuHasAvx2() {
+#if defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7) return false;
+    __cpuid(info, 1);
+    bool osxsave = (info[2] & (1 << 27)) != 0, avx = (info[2] & (1 << 28)) != 0;
+    if (!osxsave || !avx || (_xgetbv(0) & 6) != 6) return false;
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+#else
+    return __builtin_cpu_supports("avx2");
+#endif
+}
+
+bool cpuHasSse41() {
+#if defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 1);
+    return (info[2] & (1 << 19)) != 0;
+#else
+    return __builtin_cpu_supports("sse4.1");
+#endif
+}
+#endif // MC_NOISE_X86
+
+// 一个八度叠加到整张网格上；不足一个向量宽度的尾部走标量
+template <typename Lanes>
+void accumulateOctave(const int* p, float* out, int countX, int countZ, int stride,
+                      double x0, double z0, double dx, double dz, double y, double freq, float amplitude) {
+    double fy = y * freq;
+    double yFloor = std::floor(fy);
+    float yRel = (float)(fy - yFloor);
+
+    double xs = x0 * freq;
+    double xFloor = std::floor(xs);
+
+    RowParams r;
+    r.Y = (int)yFloor & 255;
+    r.y = yRel;
+    r.v = fadeScalar(yRel);
+    r.xBase = (int)xFloor;
+    r.xFrac = (float)(xs - xFloor);
+    r.xStep = (float)(dx * freq);
+
+    float tmp[8];
+    for (int j = 0; j < countZ; ++j) {
+        double fz = (z0 + j * dz) * freq;
+        double zFloor = std::floor(fz);
+        r.Z = (int)zFloor & 255;
+        r.z = (float)(fz - zFloor);
+        r.w = fadeScalar(r.z);
+
+        float* row = out + (size_t)j * stride;
+        int i = 0;
+        for (; i + Lanes::N <= countX; i += Lanes::N) {
+            Lanes::noise(p, r, i, tmp);
+            for (int k = 0; k < Lanes::N; ++k) row[i + k] += tmp[k] * amplitude;
+        }
+        for (; i < countX; ++i) {
+            ScalarLanes::noise(p, r, i, tmp);
+            row[i] += tmp[0] * amplitude;
+        }
+    }
+}
+
+enum class Backend { Scalar, Sse41, Avx2 };
+
+Backend detectBackend() {
+#ifdef MC_NOISE_X86
+    if (cpuHasAvx2()) return Backend::Avx2;
+    if (cpuHasSse41()) return Backend::Sse41;
+#endif
+    return Backend::Scalar;
+}
+
+const Backend activeBackend = detectBackend();
+
+} // namespace
+
+const char* PerlinNoise::batchBackend() {
+    switch (activeBackend) {
+        case Backend::Avx2: return "avx2";
+        case Backend::Sse41: return "sse4.1";
+        default: return "scalar";
+    }
+}
+
+void PerlinNoise::fbmGrid(float* out, int countX, int countZ, int stride,
+                          double x0, double z0, double dx, double dz, double y,
+                          int octaves, double persistence, double lacunarity) const {
+    for (int j = 0; j < countZ; ++j)
+        for (int i = 0; i < countX; ++i) out[(size_t)j * stride + i] = 0.0f;
+
+    double frequency = 1.0;
+    double amplitude = 1.0;
+    double maxValue = 0.0;
+    for (int o = 0; o < octaves; ++o) {
+        switch (activeBackend) {
+#ifdef MC_NOISE_X86
+            case Backend::Avx2:
+                accumulateOctave<AvxLanes>(p.data(), out, countX, countZ, stride, x0, z0, dx, dz, y, frequency, (float)amplitude);
+                break;
+            case Backend::Sse41:
+                accumulateOctave<SseLanes>(p.data(), out, countX, countZ, stride, x0, z0, dx, dz, y, frequency, (float)amplitude);
+                break;
+#endif
+            default:
+                accumulateOctave<ScalarLanes>(p.data(), out, countX, countZ, stride, x0, z0, dx, dz, y, frequency, (float)amplitude);
+                break;
+        }
+        maxValue += amplitude;
+        amplitude *= persistence;
+        frequency *= lacunarity;
+    }
+
+    float inv = (float)(1.0 / maxValue);
+    for (int j = 0; j < countZ; ++j)
+        for (int i = 0; i < countX; ++i) out[(size_t)j * stride + i] *= inv;
+}
@@ -1,6 +1,9 @@
 #pragma once
 #include <glm/glm.hpp>
+#include <algorithm>
+#include <cmath>
 #include "../World/World.hpp" // 前向声明
+#include "../World/BlockView.hpp"
 
 struct RayHit {
     bool hit;
@@ -18,22 +21,39 @@ public:
         glm::vec3 tDelta = 1.0f / glm::abs(direction);
         glm::vec3 dist(0);
 
-        // 初始化步进
-        if (step.x > 0) dist.x = (p.x + 1 - start.x) * tDelta.x;
-        else dist.x = (start.x - p.x) * tDelta.x;
-        
-        if (step.y > 0) dist.y = (p.y + 1 - start.y) * tDelta.y;
-        else dist.y = (start.y - p.y) * tDelta.y;
+        // 射线经过的区块一次解析好 (包围盒外扩一格，容忍边界上的浮点误差)
+        glm::vec3 end = start + direction * maxDist;
+        BlockView view(world, glm::ivec3(glm::floor(glm::min(start, end))) - 1,
+                              glm::ivec3(glm::floor(glm::max(start, end))) + 1);
+
+        // 从体素 p 到三个方向上下一条边界的射线参数 (均从 start 起算)
+        auto initDist = [&]() {
+            if (step.x > 0) dist.x = (p.x + 1 - start.x) * tDelta.x;
+            else dist.x = (start.x - p.x) * tDelta.x;
 
-        if (step.z > 0) dist.z = (p.z + 1 - start.z) * tDelta.z;
-        else dist.z = (start.z - p.z) * tDelta.z;
+            if (step.y > 0) dist.y = (p.y + 1 - start.y) * tDelta.y;
+            else dist.y = (start.y - p.y) * tDelta.y;
+
+            if (step.z > 0) dist.z = (p.z + 1 - start.z) * tDelta.z;
+            else dist.z = (start.z - p.z) * tDelta.z;
+        };
+        // 初始化步进
+        initDist();
 
         glm::ivec3 face(0);
         float travelled = 0;
 
         while (travelled < maxDist) {
+            // 整段都是空气：直接跳到射线离开这一段的体素，不再逐格步进
+            if (view.isSectionEmpty(p.x, p.y, p.z)) {
+                skipSection(start, direction, step, tDelta, p, face, travelled);
+                initDist();
+                continue;
+            }
+
             // 检查当前方块
-            if (world.getBlock(p.x, p.y, p.z) != AIR && world.getBlock(p.x, p.y, p.z) != WATER) {
+            BlockType b = view.get(p.x, p.y, p.z);
+            if (b != AIR && b != WATER) {
                 return {true, p, face, travelled};
             }
 
@@ -54,4 +74,32 @@ public:
         }
         return {false, {0,0,0}, {0,0,0}, maxDist};
     }
+
+private:
+    static int floorDiv(int a, int b) { return (a >= 0) ? a / b : (a + 1) / b - 1; }
+
+    // 把 p 移到射线穿出当前段 (CHUNK_W x SECTION_H x CHUNK_W 的盒子) 后进入的第一个体素
+    static void skipSection(const glm::vec3& start, const glm::vec3& direction, const glm::vec3& step,
+                            const glm::vec3& tDelta, glm::ivec3& p, glm::ivec3& face, float& travelled) {
+        glm::ivec3 lo(floorDiv(p.x, CHUNK_W) * CHUNK_W, floorDiv(p.y, SECTION_H) * SECTION_H, floorDiv(p.z, CHUNK_W) * CHUNK_W);
+        glm::ivec3 hi = lo + glm::ivec3(CHUNK_W, SECTION_H, CHUNK_W);
+
+        int axis = 0;
+        float tExit = 1e30f;
+        for (int i = 0; i < 3; ++i) {
+            float t;
+            if (step[i] > 0) t = (hi[i] - start[i]) * tDelta[i];
+            else if (step[i] < 0) t = (start[i] - lo[i]) * tDelta[i];
+            else continue;
+            if (t < tExit) { tExit = t; axis = i; }
+        }
+
+        for (int i = 0; i < 3; ++i) {
+            if (i == axis) p[i] = step[i] > 0 ? hi[i] : lo[i] - 1;
+            else p[i] = glm::clamp((int)std::floor(start[i] + direction[i] * tExit), lo[i], hi[i] - 1);
+        }
+        face = glm::ivec3(0);
+        face[axis] = -(int)step[axis];
+        travelled = std::max(travelled, tExit);
+    }
 };
\ No newline at end of file
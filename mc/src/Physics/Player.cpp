@@ -1,5 +1,6 @@
 // Player.cpp
 #include "Player.hpp"
+#include "../World/BlockView.hpp"
 #include <iostream>
 
 void Player::toggleMode() {
@@ -95,14 +96,19 @@ bool Player::checkCollision(glm::vec3 nextPos, World& world) {
     int minY = floor(pBox.min.y); int maxY = floor(pBox.max.y);
     int minZ = floor(pBox.min.z); int maxZ = floor(pBox.max.z);
 
-    for (int x = minX; x <= maxX; x++) {
-        for (int y = minY; y <= maxY; y++) {
-            for (int z = minZ; z <= maxZ; z++) {
-                BlockType b = world.getBlock(x, y, z);
-                if (b != AIR && b != WATER) { // 实心方块
-                    return true;
-                }
-            }
+    // 碰撞箱涉及的区块只解析一次，涉及的段都是空气就不用逐格检查
+    glm::ivec3 lo(minX, minY, minZ), hi(maxX, maxY, maxZ);
+    BlockView view(world, lo, hi);
+    if (view.isEmpty()) return false;
+
+    // 碰撞箱最多覆盖 2 x 3 x 2 个格子，一次批量读到栈上再检查
+    glm::ivec3 size = hi - lo + 1;
+    BlockType cells[2 * 3 * 2];
+    int count = size.x * size.y * size.z;
+    view.read(lo, hi, cells);
+    for (int i = 0; i < count; ++i) {
+        if (cells[i] != AIR && cells[i] != WATER) { // 实心方块
+            return true;
         }
     }
     return false;
@@ -26,9 +26,10 @@ public:
 
     void update(float dt, World& world, bool inputs[6]); // Inputs: W,S,A,D,Space,Ctrl
     void toggleMode();
+    // 玩家脚底位于 nextPos 时碰撞箱是否与实心方块重叠
+    bool checkCollision(glm::vec3 nextPos, World& world);
 
 private:
     void handleSurvivalMovement(float dt, World& world, bool inputs[6]);
-    bool checkCollision(glm::vec3 nextPos, World& world);
     AABB getAABB(glm::vec3 pos);
 };
\ No newline at end of file
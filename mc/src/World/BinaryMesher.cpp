@@ -0,0 +1,151 @@
+// 位掩码贪婪网格：与 Chunk::buildGreedyMesh 规则相同、输出相同的四边形集合
+// 每个方向把快照转成 64 位行掩码 (每行沿切片的 u 轴，一位一个格子)，按方块类型分开存放：
+//  - 面剔除：相邻两层的行掩码做与/非运算，一次得到一整行的可见面
+//  - 合并：同一类型的面互不影响，逐类型用 countr_zero 找起点、找连续段宽度，再向下一行整段比对
+#include "Chunk.hpp"
+#include <algorithm>
+#include <bit>
+
+namespace {
+
+constexpr int MAX_TYPES = 8;
+static_assert(SAND < MAX_TYPES, "binary mesher keeps one mask set per block type");
+
+// 方向 axis 上的行掩码：层 L = 坐标 + 1 (0 与 dims[axis]+1 为 halo 或世界外的空气)，
+// 每层 rows 行，行号为 v 轴坐标，位号为 u 轴坐标
+struct AxisMasks {
+    int layers = 0, rows = 0;
+    std::vector<uint64_t> type[MAX_TYPES];
+    std::vector<uint64_t> solid;
+
+    void init(int layerCount, int rowCount) {
+        if (layers == layerCount && rows == rowCount) return;
+        layers = layerCount;
+        rows = rowCount;
+        for (auto& t : type) t.assign((size_t)layers * rows, 0);
+        solid.assign((size_t)layers * rows, 0);
+    }
+    uint64_t* row(int t, int layer) { return type[t].data() + (size_t)layer * rows; }
+};
+
+struct MaskSet {
+    AxisMasks axis[3];
+};
+
+bool isSolid(int t) { return t != AIR && t != WATER; }
+
+constexpr uint64_t lowBits(int n) { return n >= 64 ? ~0ull : ((1ull << n) - 1); }
+
+} // namespace
+
+void Chunk::buildBinaryMesh(const ChunkSnapshot& snap, ChunkMesh& out) const {
+    if (CHUNK_H > 64) {
+        // 行掩码放不下整列高度，退回逐格版本
+        buildGreedyMesh(snap, out);
+        return;
+    }
+    out.clear();
+    const int dims[3] = {CHUNK_W, CHUNK_H, CHUNK_W};
+
+    thread_local MaskSet masks;
+    AxisMasks& mx = masks.axis[0]; // X 方向切片: 层 x, 行 z, 位 y
+    AxisMasks& my = masks.axis[1]; // Y 方向切片: 层 y, 行 x, 位 z
+    AxisMasks& mz = masks.axis[2]; // Z 方向切片: 层 z, 行 y, 位 x
+    mx.init(CHUNK_W + 2, CHUNK_W);
+    my.init(CHUNK_H + 2, CHUNK_W);
+    mz.init(CHUNK_W + 2, CHUNK_H);
+
+    // 1. 一遍扫描快照，同时填三个方向的类型掩码
+    unsigned present = 0;
+    for (int x = -1; x <= CHUNK_W; ++x) {
+        bool inX = x >= 0 && x < CHUNK_W;
+        for (int y = 0; y < CHUNK_H; ++y) {
+            const BlockType* column = &snap.cells[ChunkSnapshot::index(x, y, -1)];
+            for (int z = -1; z <= CHUNK_W; ++z) {
+                BlockType t = column[z + 1];
+                if (t == AIR) continue;
+                bool inZ = z >= 0 && z < CHUNK_W;
+                if (!inX && !inZ) continue; // 角上的 halo 用不到
+                present |= 1u << t;
+                if (inZ) mx.row(t, x + 1)[z] |= 1ull << y;
+                if (inX && inZ) my.row(t, y + 1)[x] |= 1ull << z;
+                if (inX) mz.row(t, z + 1)[y] |= 1ull << x;
+            }
+        }
+    }
+
+    // 2. 逐方向、逐切片求可见面并合并
+    for (int axis = 0; axis < 3; ++axis) {
+        AxisMasks& m = masks.axis[axis];
+        int u = (axis + 1) % 3;
+        int v = (axis + 2) % 3;
+        const uint64_t full = lowBits(dims[u]);
+        const size_t cells = (size_t)m.layers * m.rows;
+
+        // 实心掩码 = 所有实心类型之和
+        std::fill(m.solid.begin(), m.solid.end(), 0);
+        for (int t = 0; t < MAX_TYPES; ++t) {
+            if (!(present & (1u << t)) || !isSolid(t)) continue;
+            for (size_t i = 0; i < cells; ++i) m.solid[i] |= m.type[t][i];
+        }
+        const uint64_t* water = m.type[WATER].data();
+
+        std::vector<uint64_t> pos(m.rows), neg(m.rows);
+        int x[3] = {0, 0, 0};
+        for (int k = -1; k < dims[axis]; ++k) {
+            // 比较第 k 层 (a) 与第 k+1 层 (b)
+            const size_t a = (size_t)(k + 1) * m.rows, b = (size_t)(k + 2) * m.rows;
+            x[axis] = k + 1;
+            out.sliceOffsets[sliceIndex(axis, k + 1)] = (uint32_t)out.vertices.size();
+
+            for (int t = 1; t < MAX_TYPES; ++t) {
+                if (!(present & (1u << t))) continue;
+                const uint64_t* ta = m.type[t].data() + a;
+                const uint64_t* tb = m.type[t].data() + b;
+
+                // 实心方块贴着非实心可见；水只在贴着空气时可见
+                bool anyPos = false, anyNeg = false;
+                for (int r = 0; r < m.rows; ++r) {
+                    uint64_t solidA = m.solid[a + r], solidB = m.solid[b + r];
+                    uint64_t openA = isSolid(t) ? ~solidA : ~(solidA | water[a + r]);
+                    uint64_t openB = isSolid(t) ? ~solidB : ~(solidB | water[b + r]);
+                    pos[r] = ta[r] & openB & full;
+                    neg[r] = tb[r] & openA & full;
+                    anyPos |= pos[r] != 0;
+                    anyNeg |= neg[r] != 0;
+                }
+                // 面只归属于可见方块所在的区块
+                if (k < 0) anyPos = false;
+                if (k >= dims[axis] - 1) anyNeg = false;
+
+                for (int pass = 0; pass < 2; ++pass) {
+                    bool isBack = pass == 0;
+                    if (isBack ? !anyPos : !anyNeg) continue;
+                    std::vector<uint64_t>& rows = isBack ? pos : neg;
+                    for (int j = 0; j < m.rows; ++j) {
+                        while (rows[j]) {
+                            int i = std::countr_zero(rows[j]);
+                            int w = std::countr_one(rows[j] >> i);
+                            uint64_t run = lowBits(w) << i;
+                            rows[j] &= ~run;
+                            int h = 1;
+                            while (j + h < m.rows && (rows[j + h] & run) == run) {
+                                rows[j + h] &= ~run;
+                                ++h;
+                            }
+                            x[u] = i; x[v] = j;
+                            pushQuad(out.vertices, axis, x, w, h, u, v, (BlockType)t, isBack);
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    out.sliceOffsets[SLICE_COUNT] = (uint32_t)out.vertices.size();
+
+    // 3. 清掉本次用到的类型掩码，下次复用
+    for (int axis = 0; axis < 3; ++axis)
+        for (int t = 0; t < MAX_TYPES; ++t)
+            if (present & (1u << t)) std::fill(masks.axis[axis].type[t].begin(), masks.axis[axis].type[t].end(), 0);
+}
@@ -0,0 +1,121 @@
+#include "BlockStorage.hpp"
+#include <algorithm>
+
+// 调色板大小对应的最小位宽 (只取 2 的幂，保证下标不会跨越 64 位字)
+static int bitsForPalette(size_t count) {
+    if (count <= 1) return 0;
+    if (count <= 2) return 1;
+    if (count <= 4) return 2;
+    if (count <= 16) return 4;
+    return 8;
+}
+
+BlockStorage::BlockStorage(int size) : size(size) {
+    palette.push_back(AIR);
+}
+
+int BlockStorage::paletteIndex(BlockType type) const {
+    for (size_t i = 0; i < palette.size(); ++i)
+        if (palette[i] == type) return (int)i;
+    return -1;
+}
+
+void BlockStorage::resize(int newBits, bool keep) {
+    // 只有要保留旧下标时才换出旧数组；否则原地复用 data 的容量 (区块池回收的存储重新打包时不再分配)，
+    // 变回单值模式时也保留容量
+    int oldBits = bits, oldBitShift = bitShift, oldWordShift = wordShift, oldWordMask = wordMask;
+    uint64_t oldValueMask = valueMask;
+    keep = keep && oldBits != 0 && newBits != 0;
+    std::vector<uint64_t> old;
+    if (keep) old.swap(data);
+
+    bits = newBits;
+    if (bits == 0) { bitShift = wordShift = wordMask = 0; valueMask = 0; data.clear(); return; }
+    bitShift = (bits == 1) ? 0 : (bits == 2) ? 1 : (bits == 4) ? 2 : 3;
+    wordShift = 6 - bitShift;
+    wordMask = (1 << wordShift) - 1;
+    valueMask = (1ull << bits) - 1;
+    data.assign(((size_t)size * bits + 63) / 64, 0);
+
+    // 旧数据是单值模式时下标全为 0，新数组保持清零即可
+    if (!keep) return;
+    for (int i = 0; i < size; ++i) {
+        uint64_t v = (old[i >> oldWordShift] >> ((i & oldWordMask) << oldBitShift)) & oldValueMask;
+        writeIndex(i, v);
+    }
+}
+
+void BlockStorage::set(int index, BlockType type) {
+    int id = paletteIndex(type);
+    if (id < 0) {
+        palette.push_back(type);
+        id = (int)palette.size() - 1;
+        int need = bitsForPalette(palette.size());
+        if (need > bits) resize(need);
+    }
+    if (bits == 0) return; // 仍是单值且写入的就是该值
+    writeIndex(index, (uint64_t)id);
+}
+
+void BlockStorage::fill(BlockType type) {
+    palette.assign(1, type);
+    resize(0);
+}
+
+void BlockStorage::pack(const BlockType* in) {
+    // 先统计出现过的方块种类，一次性确定位宽，避免逐步扩容
+    bool seen[256] = {false};
+    uint8_t lookup[256];
+    palette.clear();
+    for (int i = 0; i < size; ++i) {
+        if (!seen[in[i]]) {
+            seen[in[i]] = true;
+            lookup[in[i]] = (uint8_t)palette.size();
+            palette.push_back(in[i]);
+        }
+    }
+    resize(bitsForPalette(palette.size()), false);
+    if (bits == 0) return;
+
+    // 按字写入：每个 64 位字装满再落盘
+    int perWord = 64 >> bitShift;
+    size_t words = data.size();
+    for (size_t w = 0; w < words; ++w) {
+        uint64_t word = 0;
+        int base = (int)(w * perWord);
+        int end = std::min(base + perWord, size);
+        for (int i = base; i < end; ++i)
+            word |= (uint64_t)lookup[in[i]] << ((i - base) << bitShift);
+        data[w] = word;
+    }
+}
+
+// 位宽作为编译期常量，内层循环可以完全展开
+template <int Bits>
+static void unpackWords(const uint64_t* data, int size, const BlockType* palette, BlockType* out) {
+    constexpr int perWord = 64 / Bits;
+    constexpr uint64_t mask = (1ull << Bits) - 1;
+    size_t full = (size_t)size / perWord;
+    for (size_t w = 0; w < full; ++w) {
+        uint64_t word = data[w];
+        BlockType* dst = out + w * perWord;
+        for (int i = 0; i < perWord; ++i)
+            dst[i] = palette[(word >> (i * Bits)) & mask];
+    }
+    for (int i = (int)(full * perWord); i < size; ++i)
+        out[i] = palette[(data[i / perWord] >> ((i % perWord) * Bits)) & mask];
+}
+
+void BlockStorage::unpack(BlockType* out) const {
+    switch (bits) {
+        case 0: std::fill(out, out + size, palette[0]); break;
+        case 1: unpackWords<1>(data.data(), size, palette.data(), out); break;
+        case 2: unpackWords<2>(data.data(), size, palette.data(), out); break;
+        case 4: unpackWords<4>(data.data(), size, palette.data(), out); break;
+        default: unpackWords<8>(data.data(), size, palette.data(), out); break;
+    }
+}
+
+size_t BlockStorage::memoryUsage() const {
+    return sizeof(*this) + palette.capacity() * sizeof(BlockType) + data.capacity() * sizeof(uint64_t);
+}
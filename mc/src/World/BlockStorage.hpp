@@ -0,0 +1,49 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+#include "BlockType.hpp"
+
+// 调色板压缩的方块存储
+// 只记录区块里实际出现过的方块种类 (palette)，每个格子存调色板下标，按 1/2/4/8 位紧密打包。
+// 整块都是同一种方块 (全空气 / 全泥土) 时退化为单值模式，不分配下标数组。
+class BlockStorage {
+public:
+    explicit BlockStorage(int size);
+
+    BlockType get(int index) const {
+        if (bits == 0) return palette[0]; // 单值快速路径
+        uint64_t word = data[index >> wordShift];
+        int offset = (index & wordMask) << bitShift;
+        return palette[(word >> offset) & valueMask];
+    }
+    void set(int index, BlockType type);
+    void fill(BlockType type);
+
+    // 批量打包/解包，地形生成与网格构建走这条路径，避免逐格调用 get/set
+    void pack(const BlockType* in);
+    void unpack(BlockType* out) const;
+
+    bool isUniform() const { return bits == 0; }
+    int bitsPerBlock() const { return bits; }
+    int paletteSize() const { return (int)palette.size(); }
+    size_t memoryUsage() const; // 字节数，含调色板
+
+private:
+    int size;
+    int bits = 0;       // 0 = 单值模式
+    int bitShift = 0;   // log2(bits)
+    int wordShift = 0;  // log2(64 / bits)
+    int wordMask = 0;   // 64 / bits - 1
+    uint64_t valueMask = 0;
+    std::vector<BlockType> palette;
+    std::vector<uint64_t> data;
+
+    int paletteIndex(BlockType type) const;
+    void resize(int newBits, bool keep = true);
+    void writeIndex(int index, uint64_t value) {
+        uint64_t& word = data[index >> wordShift];
+        int offset = (index & wordMask) << bitShift;
+        word = (word & ~(valueMask << offset)) | (value << offset);
+    }
+};
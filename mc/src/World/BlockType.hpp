@@ -8,4 +8,7 @@ enum BlockType : uint8_t {
     STONE,
     WATER,
     SAND
-};
\ No newline at end of file
+};
+
+// 半透明方块的面单独成一段网格，在不透明的面之后按从远到近的顺序混合绘制
+inline bool isTranslucent(BlockType t) { return t == WATER; }
\ No newline at end of file
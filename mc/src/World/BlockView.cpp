@@ -0,0 +1,56 @@
+#include "BlockView.hpp"
+#include "World.hpp"
+#include <algorithm>
+
+BlockView::BlockView(const World& world, const glm::ivec3& lo, const glm::ivec3& hi)
+    : lo(lo), hi(hi)
+{
+    cx0 = lo.x >> CHUNK_SHIFT;
+    cz0 = lo.z >> CHUNK_SHIFT;
+    countX = (hi.x >> CHUNK_SHIFT) - cx0 + 1;
+    countZ = (hi.z >> CHUNK_SHIFT) - cz0 + 1;
+
+    chunks = inlineChunks.data();
+    if (countX * countZ > INLINE_CHUNKS) {
+        heapChunks.resize((size_t)countX * countZ);
+        chunks = heapChunks.data();
+    }
+    for (int i = 0; i < countX; ++i)
+        for (int k = 0; k < countZ; ++k)
+            chunks[i * countZ + k] = world.findChunk(cx0 + i, cz0 + k);
+}
+
+bool BlockView::isEmpty() const {
+    int s0 = std::max(lo.y, 0) / SECTION_H;
+    int s1 = std::min(hi.y, CHUNK_H - 1) / SECTION_H;
+    for (int i = 0; i < countX * countZ; ++i) {
+        if (!chunks[i]) continue;
+        for (int s = s0; s <= s1; ++s)
+            if (!chunks[i]->blocks.sections[s].isEmpty()) return false;
+    }
+    return true;
+}
+
+void BlockView::read(const glm::ivec3& lo, const glm::ivec3& hi, BlockType* out) const {
+    const int sizeY = hi.y - lo.y + 1;
+    const int sizeZ = hi.z - lo.z + 1;
+
+    for (int x = lo.x; x <= hi.x; ++x) {
+        const int lx = x & LOCAL_MASK;
+        // z 方向按区块切成若干段，每段内区块不变
+        for (int z0 = lo.z; z0 <= hi.z; ) {
+            const int z1 = std::min(hi.z, ((z0 >> CHUNK_SHIFT) + 1) * CHUNK_W - 1);
+            const Chunk* chunk = chunkAt(x >> CHUNK_SHIFT, z0 >> CHUNK_SHIFT);
+            BlockType* row = out + ((size_t)(x - lo.x) * sizeY) * sizeZ + (z0 - lo.z);
+
+            for (int y = lo.y; y <= hi.y; ++y, row += sizeZ) {
+                if (!chunk || (unsigned)y >= (unsigned)CHUNK_H) { std::fill(row, row + (z1 - z0 + 1), AIR); continue; }
+                const ChunkSection& sec = chunk->section(y);
+                if (sec.isUniform()) { std::fill(row, row + (z1 - z0 + 1), sec.uniformType()); continue; }
+                const int ly = y % SECTION_H;
+                for (int z = z0; z <= z1; ++z) row[z - z0] = sec.get(lx, ly, z & LOCAL_MASK);
+            }
+            z0 = z1 + 1;
+        }
+    }
+}
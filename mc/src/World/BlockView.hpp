@@ -0,0 +1,58 @@
+#pragma once
+#include <glm/glm.hpp>
+#include <array>
+#include <bit>
+#include <vector>
+#include "Chunk.hpp"
+
+class World;
+
+// 区域只读视图：构造时把与方块盒 [lo, hi] (含两端，世界坐标) 相交的区块一次解析好，
+// 之后每次读取只是移位 + 下标运算，不再逐格做整除、查网格/哈希表
+// 只在主线程短时间使用 (一次射线 / 一次碰撞检测)；期间不能增删区块
+class BlockView {
+public:
+    BlockView(const World& world, const glm::ivec3& lo, const glm::ivec3& hi);
+    BlockView(const BlockView&) = delete;
+    BlockView& operator=(const BlockView&) = delete;
+
+    // 未加载的区块、世界高度之外与视图覆盖的区块之外都按空气处理
+    BlockType get(int x, int y, int z) const {
+        const ChunkSection* sec = section(x, y, z);
+        return sec ? sec->get(x & LOCAL_MASK, y % SECTION_H, z & LOCAL_MASK) : AIR;
+    }
+    bool isSectionEmpty(int x, int y, int z) const {
+        const ChunkSection* sec = section(x, y, z);
+        return !sec || sec->isEmpty();
+    }
+    // 视图范围内的段是否全为空气
+    bool isEmpty() const;
+
+    // 批量读取 [lo, hi] (需在视图范围内) 到 out，布局 [x][y][z]，z 变化最快，
+    // 共 (hi - lo + 1) 三个分量之积个；单值段整行填充
+    void read(const glm::ivec3& lo, const glm::ivec3& hi, BlockType* out) const;
+
+private:
+    static_assert((CHUNK_W & (CHUNK_W - 1)) == 0, "BlockView relies on power-of-two chunk width");
+    static constexpr int CHUNK_SHIFT = std::countr_zero((unsigned)CHUNK_W);
+    static constexpr int LOCAL_MASK = CHUNK_W - 1;
+    static constexpr int INLINE_CHUNKS = 16;
+
+    glm::ivec3 lo, hi;
+    int cx0, cz0, countX, countZ;
+    // 区块指针表 [cx - cx0][cz - cz0]，缺失为 nullptr；一般不超过 4x4，放在对象内免去堆分配
+    std::array<const Chunk*, INLINE_CHUNKS> inlineChunks{};
+    std::vector<const Chunk*> heapChunks;
+    const Chunk** chunks;
+
+    const Chunk* chunkAt(int cx, int cz) const {
+        unsigned i = (unsigned)(cx - cx0), k = (unsigned)(cz - cz0);
+        if (i >= (unsigned)countX || k >= (unsigned)countZ) return nullptr;
+        return chunks[i * countZ + k];
+    }
+    const ChunkSection* section(int x, int y, int z) const {
+        if ((unsigned)y >= (unsigned)CHUNK_H) return nullptr;
+        const Chunk* c = chunkAt(x >> CHUNK_SHIFT, z >> CHUNK_SHIFT);
+        return c ? &c->section(y) : nullptr;
+    }
+};
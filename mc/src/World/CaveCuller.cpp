@@ -0,0 +1,78 @@
+#include "CaveCuller.hpp"
+#include "World.hpp"
+#include <cmath>
+
+void CaveCuller::enter(const Chunk& chunk, int cx, int cz, int s, uint8_t entry, uint8_t dirs) {
+    uint8_t& mask = entered[columnIndex(cx, cz) * SECTION_COUNT + s];
+    // 同一段从不同的面进入可能通向不同的出口，各扩展一次
+    if (mask & (1 << entry)) return;
+    if (mask == 0) ++visitedSections;
+    mask |= 1 << entry;
+    reached[columnIndex(cx, cz)] = 1;
+    queue.push_back({&chunk, cx, cz, s, entry, dirs});
+}
+
+void CaveCuller::cull(const World& world, const glm::vec3& cameraPos, const Frustum& frustum,
+                      const std::vector<Chunk*>& candidates, std::vector<Chunk*>& out) {
+    out.clear();
+    frustumChunks = (int)candidates.size();
+    visitedSections = 0;
+
+    originX = (int)std::floor(cameraPos.x / CHUNK_W);
+    originZ = (int)std::floor(cameraPos.z / CHUNK_W);
+    radius = world.getRenderDistance() + world.unloadMargin + 1;
+    side = radius * 2 + 1;
+    entered.assign((size_t)side * side * SECTION_COUNT, 0);
+    reached.assign((size_t)side * side, 0);
+    queue.clear();
+
+    int cy = (int)std::floor(cameraPos.y);
+    if (cy >= 0 && cy < CHUNK_H) {
+        const Chunk* start = world.findChunk(originX, originZ);
+        if (!start) {
+            out = candidates;
+            visibleChunks = (int)out.size();
+            return;
+        }
+        enter(*start, originX, originZ, cy / SECTION_H, NO_FACE, 0);
+    } else {
+        // 相机在世界高度之外：从视锥内各区块朝向相机的那一层段进入
+        bool above = cy >= CHUNK_H;
+        int s = above ? SECTION_COUNT - 1 : 0;
+        uint8_t face = above ? 2 : 3;
+        for (Chunk* c : candidates) {
+            int cx = c->worldPos.x / CHUNK_W, cz = c->worldPos.z / CHUNK_W;
+            AABB box{glm::vec3(c->worldPos.x, s * SECTION_H, c->worldPos.z),
+                     glm::vec3(c->worldPos.x + CHUNK_W, (s + 1) * SECTION_H, c->worldPos.z + CHUNK_W)};
+            if (inRange(cx, cz) && frustum.isBoxVisible(box)) enter(*c, cx, cz, s, face, 1 << (face ^ 1));
+        }
+    }
+
+    for (size_t head = 0; head < queue.size(); ++head) {
+        const Node n = queue[head];
+        const SectionVisibility& vis = n.chunk->visibility[n.s];
+        for (int d = 0; d < 6; ++d) {
+            if (n.dirs & (1 << (d ^ 1))) continue;
+            if (n.entry != NO_FACE && !vis.connected(n.entry, d)) continue;
+
+            int cx = n.cx + (d == 0) - (d == 1);
+            int s  = n.s  + (d == 2) - (d == 3);
+            int cz = n.cz + (d == 4) - (d == 5);
+            if (s < 0 || s >= SECTION_COUNT || !inRange(cx, cz)) continue;
+            const Chunk* next = (cx == n.cx && cz == n.cz) ? n.chunk : world.findChunk(cx, cz);
+            if (!next) continue;
+
+            AABB box{glm::vec3(cx * CHUNK_W, s * SECTION_H, cz * CHUNK_W),
+                     glm::vec3((cx + 1) * CHUNK_W, (s + 1) * SECTION_H, (cz + 1) * CHUNK_W)};
+            if (!frustum.isBoxVisible(box)) continue;
+            enter(*next, cx, cz, s, d ^ 1, n.dirs | (1 << d));
+        }
+    }
+
+    // 超出遍历范围的区块 (理论上不会出现) 保守地保留
+    for (Chunk* c : candidates) {
+        int cx = c->worldPos.x / CHUNK_W, cz = c->worldPos.z / CHUNK_W;
+        if (!inRange(cx, cz) || reached[columnIndex(cx, cz)]) out.push_back(c);
+    }
+    visibleChunks = (int)out.size();
+}
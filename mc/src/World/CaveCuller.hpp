@@ -0,0 +1,46 @@
+#pragma once
+#include <glm/glm.hpp>
+#include <cstdint>
+#include <vector>
+#include "Chunk.hpp"
+#include "../Math/Frustum.hpp"
+
+class World;
+
+// 洞穴剔除 (类似 Minecraft 的 advanced cave culling)：
+// 以段为节点、段间共享的面为边，从相机所在段广度优先遍历；只有从进入面能连通到出去面 (SectionVisibility)、
+// 且不往回走 (已走过 +X 就不再走 -X，视线在每个轴上都是单调的) 的段才继续扩展，
+// 地下的洞穴、被山体完全挡住的区块遍历不到，不再提交绘制
+class CaveCuller {
+public:
+    // candidates 为通过视锥测试的区块，其中遍历可达的按原顺序写入 out；
+    // 相机所在区块未加载时无法遍历，全部输出
+    void cull(const World& world, const glm::vec3& cameraPos, const Frustum& frustum,
+              const std::vector<Chunk*>& candidates, std::vector<Chunk*>& out);
+
+    // 统计 (最近一次 cull)
+    int frustumChunks = 0;   // 通过视锥测试的区块数
+    int visibleChunks = 0;   // 其中遍历可达、实际提交的区块数
+    int visitedSections = 0; // 遍历经过的段数
+
+private:
+    struct Node {
+        const Chunk* chunk;
+        int cx, cz, s;
+        uint8_t entry; // 进入面 (段的哪个面)，相机所在段为 NO_FACE
+        uint8_t dirs;  // 到达这里走过的方向
+    };
+    static constexpr uint8_t NO_FACE = 6;
+
+    // 以相机区块为中心、边长 side 的方形范围，每段记录已从哪些面进入过 (第 6 位 = 起点)
+    int originX = 0, originZ = 0, radius = 0, side = 0;
+    std::vector<uint8_t> entered;
+    std::vector<uint8_t> reached; // 区块是否被遍历到，下标同上 (不分段)
+    std::vector<Node> queue;
+
+    int columnIndex(int cx, int cz) const { return (cx - originX + radius) * side + (cz - originZ + radius); }
+    bool inRange(int cx, int cz) const {
+        return cx >= originX - radius && cx <= originX + radius && cz >= originZ - radius && cz <= originZ + radius;
+    }
+    void enter(const Chunk& chunk, int cx, int cz, int s, uint8_t entry, uint8_t dirs);
+};
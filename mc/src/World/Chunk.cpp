@@ -1,176 +1,320 @@
 #include "Chunk.hpp"
+#include <algorithm>
 #include <iostream>
 
-Chunk::Chunk(int x, int z, const PerlinNoise& noiseGen) 
+void ChunkBlocks::pack(const BlockType* flat) {
+    // 平铺布局中每个 x 下的一段 y 是连续的 SECTION_H * CHUNK_W 个格子，逐段拼出来再打包
+    thread_local std::vector<BlockType> buf(SECTION_VOLUME);
+    for (int s = 0; s < SECTION_COUNT; ++s) {
+        for (int x = 0; x < CHUNK_W; ++x)
+            std::copy_n(flat + Chunk::index(x, s * SECTION_H, 0), SECTION_H * CHUNK_W,
+                        buf.begin() + ChunkSection::index(x, 0, 0));
+        ChunkSection& sec = sections[s];
+        sec.blocks.pack(buf.data());
+        sec.nonAirCount = (int)std::count_if(buf.begin(), buf.end(), [](BlockType b) { return b != AIR; });
+    }
+}
+
+void ChunkBlocks::clear() {
+    for (ChunkSection& sec : sections) {
+        sec.blocks.fill(AIR);
+        sec.nonAirCount = 0;
+    }
+}
+
+void ChunkBlocks::unpack(BlockType* flat) const {
+    thread_local std::vector<BlockType> buf(SECTION_VOLUME);
+    for (int s = 0; s < SECTION_COUNT; ++s) {
+        const ChunkSection& sec = sections[s];
+        if (sec.isUniform()) {
+            BlockType t = sec.uniformType();
+            for (int x = 0; x < CHUNK_W; ++x)
+                std::fill_n(flat + Chunk::index(x, s * SECTION_H, 0), SECTION_H * CHUNK_W, t);
+            continue;
+        }
+        sec.blocks.unpack(buf.data());
+        for (int x = 0; x < CHUNK_W; ++x)
+            std::copy_n(buf.begin() + ChunkSection::index(x, 0, 0), SECTION_H * CHUNK_W,
+                        flat + Chunk::index(x, s * SECTION_H, 0));
+    }
+}
+
+size_t ChunkBlocks::memoryUsage() const {
+    size_t total = 0;
+    for (const ChunkSection& sec : sections) total += sec.blocks.memoryUsage();
+    return total;
+}
+
+Chunk::Chunk(int x, int z) 
     : worldPos(x * CHUNK_W, 0, z * CHUNK_W) 
 {
     aabb.min = glm::vec3(worldPos);
     aabb.max = glm::vec3(worldPos) + glm::vec3(CHUNK_W, CHUNK_H, CHUNK_W);
+}
 
-    generateTerrain(noiseGen);
-    
-    // 启动后台构建网格
-    meshTask = std::async(std::launch::async, &Chunk::buildGreedyMesh, this);
+Chunk::Chunk(int x, int z, const PerlinNoise& noiseGen) 
+    : Chunk(x, z)
+{
+    generate(noiseGen);
 }
 
-Chunk::~Chunk() {
-    if(meshTask.valid()) meshTask.wait();
-    if(VAO) glDeleteVertexArrays(1, &VAO);
-    if(VBO) glDeleteBuffers(1, &VBO);
+void Chunk::reset(int x, int z) {
+    worldPos = glm::ivec3(x * CHUNK_W, 0, z * CHUNK_W);
+    aabb.min = glm::vec3(worldPos);
+    aabb.max = glm::vec3(worldPos) + glm::vec3(CHUNK_W, CHUNK_H, CHUNK_W);
+    blocks.clear();
+
+    meshOffset = 0;
+    meshVertexCount = 0;
+    meshLayout.vertices.clear();
+    meshLayout.start.fill(0);
+    meshLayout.count.fill(0);
+    meshLayout.capacity.fill(0);
+    meshUploaded = false;
+    drawnFrame = 0;
+    lod = 0;
+
+    inDirtyQueue = false;
+    needsFullRebuild = false;
+    dirtySlices.reset();
+    slicePatches.clear();
+    dirtySections.reset();
+    visibility.fill({});
+    needsSave = false;
+    editedSinceUpload = false;
+
+    pendingMesh.clear();
+    meshReady.store(false, std::memory_order_relaxed);
+    meshBuilt.store(false, std::memory_order_relaxed);
+}
+
+void Chunk::generate(const PerlinNoise& noiseGen) {
+    generateTerrain(noiseGen);
 }
 
 void Chunk::generateTerrain(const PerlinNoise& noiseGen) {
+    // 先写入平铺数组，最后一次性打包进调色板存储 (每个加载线程一份，不必每次分配)
+    thread_local std::vector<BlockType> flat(CHUNK_VOLUME);
+
+    // 整个区块的高度图一次批量算出 (SIMD)，heights[z * CHUNK_W + x]
+    // 坐标缩放系数 0.04 使地形起伏更平缓自然
+    float heights[CHUNK_W * CHUNK_W];
+    noiseGen.fbmGrid(heights, CHUNK_W, CHUNK_W, CHUNK_W,
+                     worldPos.x * 0.04, worldPos.z * 0.04, 0.04, 0.04, 0.0, 4, 0.5, 2.0);
+
     for(int x = 0; x < CHUNK_W; ++x) {
         for(int z = 0; z < CHUNK_W; ++z) {
-            // 使用自定义的 fbm 函数
-            // 坐标缩放系数 0.04 使地形起伏更平缓自然
-            double n = noiseGen.fbm((worldPos.x + x) * 0.04, 0.0, (worldPos.z + z) * 0.04, 4, 0.5, 2.0);
+            float n = heights[z * CHUNK_W + x];
             
             // 归一化后的 n 约在 -1 到 1 之间，变换到高度
-            int h = 15 + int((n + 0.5) * 25); 
+            int h = 15 + int((n + 0.5f) * 25); 
             if(h >= CHUNK_H) h = CHUNK_H - 1;
             if(h < 1) h = 1;
 
             for(int y = 0; y < CHUNK_H; ++y) {
+                BlockType& b = flat[index(x, y, z)];
                 if (y > h) {
-                    blocks[x][y][z] = (y <= WATER_LEVEL) ? WATER : AIR;
+                    b = (y <= WATER_LEVEL) ? WATER : AIR;
                 } else if (y == h) {
-                    blocks[x][y][z] = (y >= WATER_LEVEL) ? GRASS : DIRT;
+                    b = (y >= WATER_LEVEL) ? GRASS : DIRT;
                 } else {
-                    blocks[x][y][z] = DIRT;
+                    b = DIRT;
                 }
             }
         }
     }
+    blocks.pack(flat.data());
 }
 
-void Chunk::update() {
-    if (isDirty) {
-        if (meshData.empty()) { indexCount = 0; return; }
-        
-        if (VAO == 0) glGenVertexArrays(1, &VAO);
-        if (VBO == 0) glGenBuffers(1, &VBO);
-
-        glBindVertexArray(VAO);
-        glBindBuffer(GL_ARRAY_BUFFER, VBO);
-        glBufferData(GL_ARRAY_BUFFER, meshData.size() * sizeof(Vertex), meshData.data(), GL_STATIC_DRAW);
-
-        glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)0);
-        glEnableVertexAttribArray(0);
-        glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, normal));
-        glEnableVertexAttribArray(1);
-        glVertexAttribPointer(2, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, color));
-        glEnableVertexAttribArray(2);
-
-        indexCount = (GLsizei)meshData.size();
-        isDirty = false;
-        meshData.clear();
-        meshData.shrink_to_fit();
+// 两个相邻方块之间的可见面：>0 属于 b1 (法线指向 +axis)，<0 属于 b2 (法线指向 -axis)，0 无面
+// 实心方块贴着空气/水时可见，水只在贴着空气时可见
+static int faceBetween(BlockType b1, BlockType b2) {
+    bool b1Solid = (b1 != AIR && b1 != WATER);
+    bool b2Solid = (b2 != AIR && b2 != WATER);
+    if (b1 != AIR && !b2Solid && b1 != b2) return b1;
+    if (b2 != AIR && !b1Solid && b1 != b2) return -(int)b2;
+    return 0;
+}
+
+void moveTranslucentQuads(std::vector<Vertex>& vertices, std::vector<Vertex>& translucent) {
+    size_t write = 0;
+    for (size_t i = 0; i < vertices.size(); i += 4) {
+        if (isTranslucent((BlockType)(vertices[i].data1 & 255))) {
+            translucent.insert(translucent.end(), vertices.begin() + i, vertices.begin() + i + 4);
+        } else {
+            if (write != i) std::copy_n(vertices.begin() + i, 4, vertices.begin() + write);
+            write += 4;
+        }
     }
+    vertices.resize(write);
 }
 
-void Chunk::render() {
-    if (indexCount > 0) {
-        glBindVertexArray(VAO);
-        glDrawArrays(GL_TRIANGLES, 0, indexCount);
+void ChunkMesh::separateTranslucent() {
+    // 逐切面把不透明的四边形原地前移，半透明的暂存，最后整体接到末尾
+    thread_local std::vector<Vertex> translucent;
+    std::array<uint32_t, SLICE_COUNT> translucentOffsets;
+    translucent.clear();
+    uint32_t write = 0, begin = 0;
+    for (int s = 0; s < SLICE_COUNT; ++s) {
+        uint32_t end = sliceOffsets[s + 1];
+        sliceOffsets[s] = write;
+        translucentOffsets[s] = (uint32_t)translucent.size();
+        for (uint32_t i = begin; i < end; i += 4) {
+            if (isTranslucent((BlockType)(vertices[i].data1 & 255))) {
+                translucent.insert(translucent.end(), vertices.begin() + i, vertices.begin() + i + 4);
+            } else {
+                if (write != i) std::copy_n(vertices.begin() + i, 4, vertices.begin() + write);
+                write += 4;
+            }
+        }
+        begin = end;
     }
+    vertices.resize(write);
+    vertices.insert(vertices.end(), translucent.begin(), translucent.end());
+    for (int s = 0; s < SLICE_COUNT; ++s) sliceOffsets[translucentSlice(s)] = write + translucentOffsets[s];
+    sliceOffsets[MESH_SLICE_COUNT] = (uint32_t)vertices.size();
+}
+
+void Chunk::publishMesh(ChunkMesh&& mesh) {
+    std::lock_guard<std::mutex> lock(meshMutex);
+    std::swap(pendingMesh, mesh);
+    meshReady.store(true, std::memory_order_release);
+    meshBuilt.store(true, std::memory_order_release);
 }
 
-void Chunk::rebuild() {
-    meshTask = std::async(std::launch::async, &Chunk::buildGreedyMesh, this);
+bool Chunk::takeMesh(ChunkMesh& out) {
+    if (!hasPendingMesh()) return false;
+    std::lock_guard<std::mutex> lock(meshMutex);
+    std::swap(out, pendingMesh);
+    pendingMesh.clear();
+    meshReady.store(false, std::memory_order_relaxed);
+    visibility = out.visibility;
+    return true;
 }
 
+void Chunk::setVisibility(int s, const SectionVisibility& vis) {
+    std::lock_guard<std::mutex> lock(meshMutex);
+    visibility[s] = vis;
+    if (meshReady.load(std::memory_order_relaxed)) pendingMesh.visibility[s] = vis;
+}
+
+SectionVisibility Chunk::computeVisibility(const ChunkSnapshot& snap, int s) {
+    thread_local std::vector<BlockType> cells(SECTION_VOLUME);
+    for (int x = 0; x < CHUNK_W; ++x)
+        for (int y = 0; y < SECTION_H; ++y)
+            std::copy_n(&snap.cells[ChunkSnapshot::index(x, s * SECTION_H + y, 0)], CHUNK_W,
+                        &cells[ChunkSection::index(x, y, 0)]);
+    return SectionVisibility::compute(cells.data(), CHUNK_W, SECTION_H, CHUNK_W);
+}
+
+SectionVisibility Chunk::computeVisibility(int s) const {
+    const ChunkSection& sec = blocks.sections[s];
+    if (sec.isUniform()) {
+        BlockType t = sec.uniformType();
+        return (t == AIR || t == WATER) ? SectionVisibility{} : SectionVisibility::none();
+    }
+    thread_local std::vector<BlockType> cells(SECTION_VOLUME);
+    sec.blocks.unpack(cells.data());
+    return SectionVisibility::compute(cells.data(), CHUNK_W, SECTION_H, CHUNK_W);
+}
 
+void Chunk::buildGreedyMesh(const ChunkSnapshot& snap, ChunkMesh& out) const {
+    out.clear();
+    const int dims[] = {CHUNK_W, CHUNK_H, CHUNK_W};
+    std::vector<BlockType> below, above;
 
-void Chunk::buildGreedyMesh() {
-    std::vector<Vertex> tempMesh;
     for (int axis = 0; axis < 3; ++axis) {
         int u = (axis + 1) % 3;
         int v = (axis + 2) % 3;
-        int x[3] = {0}, q[3] = {0};
-        int dims[] = {CHUNK_W, CHUNK_H, CHUNK_W};
-        q[axis] = 1;
+        below.resize(dims[u] * dims[v]);
+        above.resize(dims[u] * dims[v]);
 
-        std::vector<BlockType> mask(dims[u] * dims[v]);
+        for (int plane = 0; plane <= dims[axis]; ++plane) {
+            out.sliceOffsets[sliceIndex(axis, plane)] = (uint32_t)out.vertices.size();
 
-        for (x[axis] = -1; x[axis] < dims[axis]; ) {
+            // 上下两层都在同一个封闭段里的水平切面没有面，直接跳过
+            if (axis == 1 && plane > 0 && plane < CHUNK_H &&
+                (plane - 1) / SECTION_H == plane / SECTION_H && snap.isClosedAt(plane)) continue;
+
+            // 切面两侧的两层，区块外的一侧来自邻居 halo
+            int x[3] = {0, 0, 0};
             int n = 0;
             for (x[v] = 0; x[v] < dims[v]; ++x[v]) {
-                for (x[u] = 0; x[u] < dims[u]; ++x[u]) {
-                    BlockType b1 = (x[axis] >= 0) ? blocks[x[0]][x[1]][x[2]] : AIR;
-                    BlockType b2 = (x[axis] < dims[axis]-1) ? blocks[x[0]+q[0]][x[1]+q[1]][x[2]+q[2]] : AIR;
-                    
-                    bool b1Solid = (b1 != AIR && b1 != WATER);
-                    bool b2Solid = (b2 != AIR && b2 != WATER);
-                    bool b1Water = (b1 == WATER);
-                    bool b2Water = (b2 == WATER);
-
-                    BlockType faceType = AIR;
-                    if (b1Solid && b2Solid) faceType = AIR;
-                    else if (b1 == AIR && b2 == AIR) faceType = AIR;
-                    else if (b1Solid && b2 == AIR) faceType = b1;
-                    else if (b1 == AIR && b2Solid) faceType = b2;
-                    else if (b1Water && b2 == AIR) faceType = b1;
-                    else if (b1 == AIR && b2Water) faceType = b2;
-                    else if (b1Solid && b2Water) faceType = b1;
-                    else if (b1Water && b2Solid) faceType = b2; 
-                    else if (b1Water && b2Water) faceType = AIR;
-
-                    mask[n++] = faceType;
+                for (x[u] = 0; x[u] < dims[u]; ++x[u], ++n) {
+                    // 竖直切面上属于封闭段的格子两侧必然相同
+                    if (axis != 1 && snap.isClosedAt(x[1])) { below[n] = above[n] = AIR; continue; }
+                    x[axis] = plane - 1;
+                    below[n] = snap.at(x[0], x[1], x[2]);
+                    x[axis] = plane;
+                    above[n] = snap.at(x[0], x[1], x[2]);
                 }
             }
+            buildSlice(axis, plane, below.data(), above.data(), out.vertices);
+        }
+    }
+    out.sliceOffsets[SLICE_COUNT] = (uint32_t)out.vertices.size();
+}
+
+void Chunk::buildSlice(int axis, int plane, const BlockType* below, const BlockType* above, std::vector<Vertex>& out) const {
+    const int dims[] = {CHUNK_W, CHUNK_H, CHUNK_W};
+    int u = (axis + 1) % 3;
+    int v = (axis + 2) % 3;
+
+    thread_local std::vector<int> mask;
+    mask.resize(dims[u] * dims[v]);
+    for (int n = 0; n < dims[u] * dims[v]; ++n) {
+        int face = faceBetween(below[n], above[n]);
+        // 面只归属于可见方块所在的区块，避免相邻区块在边界上各生成一份
+        if (face > 0 && plane == 0) face = 0;
+        if (face < 0 && plane == dims[axis]) face = 0;
+        mask[n] = face;
+    }
 
-            x[axis]++; 
-            n = 0;
-            for (int j = 0; j < dims[v]; ++j) {
-                for (int i = 0; i < dims[u]; ) {
-                    if (mask[n] != AIR) {
-                        BlockType type = mask[n];
-                        int w = 1;
-                        while (i + w < dims[u] && mask[n + w] == type) w++;
-                        int h = 1;
-                        bool done = false;
-                        while (j + h < dims[v]) {
-                            for (int k = 0; k < w; ++k) 
-                                if (mask[n + k + h * dims[u]] != type) { done = true; break; }
-                            if (done) break;
-                            h++;
-                        }
-
-                        x[u] = i; x[v] = j;
-                        int dx[] = {0,0,0}; dx[axis] = -1; 
-                        int rx=x[0], ry=x[1], rz=x[2];
-                        BlockType blkCheck = (rx+dx[0] >= 0) ? blocks[rx+dx[0]][ry+dx[1]][rz+dx[2]] : AIR;
-                        bool isBack = (blkCheck == type);
-
-                        pushQuad(tempMesh, axis, x, w, h, u, v, type, isBack);
-
-                        for (int l = 0; l < h; ++l)
-                            for (int k = 0; k < w; ++k)
-                                mask[n + k + l * dims[u]] = AIR;
-                        i += w; n += w;
-                    } else { i++; n++; }
+    int x[3] = {0, 0, 0};
+    x[axis] = plane;
+    int n = 0;
+    for (int j = 0; j < dims[v]; ++j) {
+        for (int i = 0; i < dims[u]; ) {
+            if (mask[n] != 0) {
+                int face = mask[n];
+                int w = 1;
+                while (i + w < dims[u] && mask[n + w] == face) w++;
+                int h = 1;
+                bool done = false;
+                while (j + h < dims[v]) {
+                    for (int k = 0; k < w; ++k) 
+                        if (mask[n + k + h * dims[u]] != face) { done = true; break; }
+                    if (done) break;
+                    h++;
                 }
-            }
+
+                x[u] = i; x[v] = j;
+                bool isBack = face > 0;
+                BlockType type = (BlockType)(isBack ? face : -face);
+                pushQuad(out, axis, x, w, h, u, v, type, isBack);
+
+                for (int l = 0; l < h; ++l)
+                    for (int k = 0; k < w; ++k)
+                        mask[n + k + l * dims[u]] = 0;
+                i += w; n += w;
+            } else { i++; n++; }
         }
     }
-    meshData = std::move(tempMesh);
-    isDirty = true;
-}
-
-void Chunk::pushQuad(std::vector<Vertex>& out, int axis, int x[3], int w, int h, int u, int v, BlockType type, bool isBack) {
-    glm::vec3 p(x[0]+worldPos.x, x[1]+worldPos.y, x[2]+worldPos.z);
-    glm::vec3 du(0), dv(0);
-    du[u] = (float)w; dv[v] = (float)h;
-    glm::vec3 n(0); n[axis] = isBack ? 1.0f : -1.0f;
-    glm::vec3 c = getColor(type, axis, isBack);
-
-    glm::vec3 v0, v1, v2, v3;
-    if (isBack) { v0 = p; v1 = p + du; v2 = p + du + dv; v3 = p + dv; } 
-    else { v0 = p; v1 = p + dv; v2 = p + du + dv; v3 = p + du; }
-    
-    out.push_back({v0, n, c}); out.push_back({v1, n, c}); out.push_back({v2, n, c});
-    out.push_back({v2, n, c}); out.push_back({v3, n, c}); out.push_back({v0, n, c});
+}
+
+void Chunk::pushQuad(std::vector<Vertex>& out, int axis, int x[3], int w, int h, int u, int v, BlockType type, bool isBack) const {
+    // 区块内相对坐标，世界偏移在着色器中加上
+    int p[3] = {x[0], x[1], x[2]};
+    int du[3] = {0, 0, 0}, dv[3] = {0, 0, 0};
+    du[u] = w; dv[v] = h;
+    int normal = axis * 2 + (isBack ? 0 : 1);
+
+    auto corner = [&](int a, int b) {
+        return Vertex::pack(p[0] + du[0] * a + dv[0] * b, p[1] + du[1] * a + dv[1] * b, p[2] + du[2] * a + dv[2] * b, normal, type);
+    };
+    // 4 个顶点，三角形由共享索引 0,1,2, 2,3,0 组成
+    if (isBack) { out.push_back(corner(0, 0)); out.push_back(corner(1, 0)); out.push_back(corner(1, 1)); out.push_back(corner(0, 1)); }
+    else        { out.push_back(corner(0, 0)); out.push_back(corner(0, 1)); out.push_back(corner(1, 1)); out.push_back(corner(1, 0)); }
 }
 
 glm::vec3 Chunk::getColor(BlockType t, int axis, bool isBack) {
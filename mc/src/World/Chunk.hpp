@@ -1,52 +1,212 @@
 #pragma once
-#include <glad/glad.h>
 #include <glm/glm.hpp>
 #include <vector>
-#include <future>
+#include <array>
 #include <atomic>
+#include <bitset>
+#include <mutex>
 #include "BlockType.hpp"
+#include "BlockStorage.hpp"
+#include "ChunkSnapshot.hpp"
+#include "SectionVisibility.hpp"
 #include "../Math/Frustum.hpp" // 为了 AABB
 #include "../Math/PerlinNoise.hpp" // 需要噪声生成器
 
 constexpr int CHUNK_W = 32;
 constexpr int CHUNK_H = 64;
 constexpr int WATER_LEVEL = 20;
+constexpr int CHUNK_VOLUME = CHUNK_W * CHUNK_H * CHUNK_W;
 
+// 区块在竖直方向切成 SECTION_H 高的段，每段单独存储；加高 CHUNK_H 只会多出几个 (大多为空的) 段
+constexpr int SECTION_H = 16;
+constexpr int SECTION_COUNT = CHUNK_H / SECTION_H;
+constexpr int SECTION_VOLUME = CHUNK_W * SECTION_H * CHUNK_W;
+static_assert(CHUNK_H % SECTION_H == 0, "chunk height must be a multiple of the section height");
+static_assert(CHUNK_H <= 512, "packed vertex y has 9 bits");
+
+using ChunkSnapshot = BasicChunkSnapshot<CHUNK_W, CHUNK_H, SECTION_H>;
+
+// 竖直方向的一段 (CHUNK_W x SECTION_H x CHUNK_W)
+// 地表以上整段空气、地下深处整段泥土都是单值存储，网格构建 / 射线 / 碰撞可整段跳过
+struct ChunkSection {
+    BlockStorage blocks{SECTION_VOLUME}; // 布局 [x][y][z]，y 为段内坐标
+    int nonAirCount = 0;
+
+    static int index(int x, int y, int z) { return (x * SECTION_H + y) * CHUNK_W + z; }
+    BlockType get(int x, int y, int z) const { return blocks.get(index(x, y, z)); }
+    void set(int x, int y, int z, BlockType type) {
+        int i = index(x, y, z);
+        BlockType old = blocks.get(i);
+        if (old == type) return;
+        nonAirCount += (type != AIR) - (old != AIR);
+        blocks.set(i, type);
+    }
+
+    bool isEmpty() const { return nonAirCount == 0; }
+    // 整段只有一种方块
+    bool isUniform() const { return blocks.isUniform(); }
+    BlockType uniformType() const { return blocks.get(0); }
+};
+
+// 一个区块的全部方块数据，按段存放；平铺布局 (Chunk::index) 只在打包/解包时出现
+struct ChunkBlocks {
+    std::array<ChunkSection, SECTION_COUNT> sections;
+
+    BlockType get(int x, int y, int z) const { return sections[y / SECTION_H].get(x, y % SECTION_H, z); }
+    void set(int x, int y, int z, BlockType type) { sections[y / SECTION_H].set(x, y % SECTION_H, z, type); }
+
+    void pack(const BlockType* flat);
+    void unpack(BlockType* flat) const;
+    size_t memoryUsage() const;
+    // 全部清成空气，下标数组保留容量 (区块池复用)
+    void clear();
+};
+
+// 紧凑顶点 (8 字节)，由 chunk.vs 解码，世界偏移由每个绘制命令的实例属性提供
+//  data0: x(6) | y(9) << 6 | z(6) << 15 | normal(3) << 21   坐标为区块内相对坐标
+//  data1: block id(8)
+// normal 编号: 0 +X, 1 -X, 2 +Y, 3 -Y, 4 +Z, 5 -Z
 struct Vertex {
-    glm::vec3 pos;
-    glm::vec3 normal;
-    glm::vec3 color;
+    uint32_t data0;
+    uint32_t data1;
+
+    static Vertex pack(int x, int y, int z, int normal, BlockType type) {
+        return { (uint32_t)x | (uint32_t)y << 6 | (uint32_t)z << 15 | (uint32_t)normal << 21, (uint32_t)type };
+    }
+};
+static_assert(sizeof(Vertex) == 8, "packed chunk vertex must stay 8 bytes");
+
+// 网格按切面分段：axis 方向上坐标为 plane 的切面 (四边形的 x[axis] == plane，plane 取 0..dims[axis])
+// 单个方块变化只影响它六个面所在的切面，可以只重建这几段
+constexpr int SLICE_COUNT = (CHUNK_W + 1) * 2 + (CHUNK_H + 1);
+inline int sliceIndex(int axis, int plane) {
+    if (axis == 0) return plane;
+    if (axis == 1) return (CHUNK_W + 1) + plane;
+    return (CHUNK_W + 1) + (CHUNK_H + 1) + plane;
+}
+// 网格里每个切面再按绘制遍分成两段：不透明的面在切面 s，半透明的面 (水) 在 translucentSlice(s)，
+// 所有不透明段在前、半透明段在后，两遍各自是一个连续区间
+constexpr int MESH_SLICE_COUNT = SLICE_COUNT * 2;
+inline int translucentSlice(int s) { return SLICE_COUNT + s; }
+
+// 把 vertices 中的半透明四边形移到 translucent 末尾，其余保持原顺序
+void moveTranslucentQuads(std::vector<Vertex>& vertices, std::vector<Vertex>& translucent);
+
+// 构建结果：顶点按切面连续存放，切面 s 的顶点为 [sliceOffsets[s], sliceOffsets[s + 1])
+struct ChunkMesh {
+    std::vector<Vertex> vertices;
+    std::array<uint32_t, MESH_SLICE_COUNT + 1> sliceOffsets{};
+    std::array<SectionVisibility, SECTION_COUNT> visibility; // 由网格任务一并计算，随网格交给主线程
+
+    void clear() { vertices.clear(); sliceOffsets.fill(0); visibility.fill({}); }
+    size_t sliceSize(int s) const { return sliceOffsets[s + 1] - sliceOffsets[s]; }
+    // 网格算法只填前 SLICE_COUNT 个切面 (两种面混在一起)，之后由此拆成不透明 / 半透明两段
+    void separateTranslucent();
+};
+
+// 主线程增量重建的单个切面，由渲染器原地覆盖到 GPU 中对应的区间
+struct SlicePatch {
+    int slice;
+    std::vector<Vertex> vertices;
+};
+
+// GPU 中的网格布局 (渲染器在主线程维护)：每个切面一段，段尾留余量并用退化四边形填满，
+// 切面重建后放得下就原地覆盖，不必重新分配和上传整个区块
+struct ChunkMeshLayout {
+    std::vector<Vertex> vertices;                        // 与 GPU 中的内容一致 (含填充)
+    std::array<uint32_t, MESH_SLICE_COUNT> start{};      // 单位：顶点
+    std::array<uint32_t, MESH_SLICE_COUNT> count{};      // 有效顶点数
+    std::array<uint32_t, MESH_SLICE_COUNT> capacity{};   // 含余量
+
+    // 两遍绘制各自的顶点区间 (相对区块网格起点)
+    uint32_t opaqueCount() const { return start[SLICE_COUNT]; }
+    uint32_t translucentStart() const { return start[SLICE_COUNT]; }
+    uint32_t translucentCount() const { return (uint32_t)vertices.size() - start[SLICE_COUNT]; }
+};
+
+// 网格构建算法，两者输出相同的四边形集合
+enum class MesherType {
+    Greedy,  // 逐格比较 + 嵌套扫描合并
+    Binary   // 64 位行掩码，移位/与运算剔除面，countr_zero 合并
 };
 
 class Chunk {
 public:
     glm::ivec3 worldPos;
-    BlockType blocks[CHUNK_W][CHUNK_H][CHUNK_W];
+    ChunkBlocks blocks; // 按段的调色板压缩存储
     
-    GLuint VAO = 0, VBO = 0;
-    GLsizei indexCount = 0;
+    // 网格在 ChunkRenderer 共享顶点缓冲中的区间 (单位: 顶点，含切面余量)
+    size_t meshOffset = 0;
+    size_t meshVertexCount = 0;
+    ChunkMeshLayout meshLayout;
+    bool meshUploaded = false; // 渲染器至少上传过一次完整网格 (空网格也算)
+    uint32_t drawnFrame = 0;   // 渲染器最近一次提交该区块的帧号 (Hi-Z 据此识别刚出现的区块)
     AABB aabb;
     
-    // 多线程状态
-    std::atomic<bool> isDirty{false};
-    std::vector<Vertex> meshData;
-    std::future<void> meshTask;
+    // 网格细节级别：0 为原始精度，l 为 2^l 倍降采样 (远处的区块)
+    // 主线程持 World::chunkMutex 独占时修改，后台线程建快照时持共享锁读取
+    int lod = 0;
+
+    bool inDirtyQueue = false;      // 已在 World 的重建队列中 (仅主线程访问)
+    bool needsFullRebuild = false;  // 整个区块重建；否则只重建 dirtySlices 中的切面
+    std::bitset<SLICE_COUNT> dirtySlices;
+    std::vector<SlicePatch> slicePatches; // 等待渲染器应用的切面 (仅主线程访问)
+    std::bitset<SECTION_COUNT> dirtySections; // 增量重建时需重算连通性的段
+    // 各段的面-面连通性，洞穴剔除据此遍历 (仅主线程访问，取走网格时更新)
+    std::array<SectionVisibility, SECTION_COUNT> visibility;
+    bool needsSave = false;    // 被编辑过，卸载/定期存档时写入区域文件
+    bool editedSinceUpload = false; // 方块被编辑或 LOD 切换后还没上传新网格 (几何变化可能让后面的区块露出来，渲染器据此跳过 Hi-Z)
 
+    // 空区块 (全空气)，由调用方填充方块数据，例如从区域文件读取
+    Chunk(int x, int z);
     // 传入全局的 PerlinNoise 引用，避免每个 Chunk 创建一个表
     Chunk(int x, int z, const PerlinNoise& noiseGen);
-    ~Chunk();
 
-    void rebuild();
-    static glm::vec3 getColor(BlockType t, int axis, bool isBack);
+    // 区块池复用：变成坐标 (x, z) 的空区块，与新构造的相同，只是各缓冲保留容量
+    // 调用方须独占该区块 (已从 World 移除、没有网格任务在读)
+    void reset(int x, int z);
+    // 生成地形 (空区块上调用，例如 reset 之后)；地形可由种子重建，不标记存档
+    void generate(const PerlinNoise& noiseGen);
+
+    static int index(int x, int y, int z) { return (x * CHUNK_H + y) * CHUNK_W + z; }
+    BlockType getBlock(int x, int y, int z) const { return blocks.get(x, y, z); }
+    void setBlock(int x, int y, int z, BlockType type) { blocks.set(x, y, z, type); }
+    const ChunkSection& section(int y) const { return blocks.sections[y / SECTION_H]; }
 
+    // 由后台线程调用，输入为含邻居 halo 的快照 (见 World::buildSnapshot)
+    void buildGreedyMesh(const ChunkSnapshot& snap, ChunkMesh& out) const;
+    void buildBinaryMesh(const ChunkSnapshot& snap, ChunkMesh& out) const; // 见 BinaryMesher.cpp
+    void buildMesh(const ChunkSnapshot& snap, ChunkMesh& out, MesherType type) const {
+        if (type == MesherType::Binary) buildBinaryMesh(snap, out);
+        else buildGreedyMesh(snap, out);
+        out.separateTranslucent();
+    }
+    // 单个切面：below / above 为切面两侧的两层方块 (plane - 1 与 plane)，
+    // 按切面的 (v, u) 行优先排列，共 dims[u] * dims[v] 个；结果追加到 out
+    void buildSlice(int axis, int plane, const BlockType* below, const BlockType* above, std::vector<Vertex>& out) const;
 
-    void update();
-    void render();
+    // 各段连通性：后台线程从快照计算 (随网格发布)，主线程增量重建时从当前方块计算
+    static SectionVisibility computeVisibility(const ChunkSnapshot& snap, int s);
+    SectionVisibility computeVisibility(int s) const;
+    // 主线程更新一段的连通性；已发布但未取走的网格中的那一份也一并更新，取走时不会被旧值覆盖
+    void setVisibility(int s, const SectionVisibility& vis);
+
+    // 后台线程发布新网格，主线程取走上传；整体交换，不会读到构建一半的数据
+    void publishMesh(ChunkMesh&& mesh);
+    bool takeMesh(ChunkMesh& out);
+    bool hasPendingMesh() const { return meshReady.load(std::memory_order_acquire); }
+    // 至少完成过一次完整构建 (之后才能按切面增量更新)
+    bool hasMesh() const { return meshBuilt.load(std::memory_order_acquire); }
+    static glm::vec3 getColor(BlockType t, int axis, bool isBack);
 
 private:
+    std::mutex meshMutex;
+    ChunkMesh pendingMesh;
+    std::atomic<bool> meshReady{false};
+    std::atomic<bool> meshBuilt{false};
+
     void generateTerrain(const PerlinNoise& noiseGen);
-    void buildGreedyMesh();
     
-    void pushQuad(std::vector<Vertex>& out, int axis, int x[3], int w, int h, int u, int v, BlockType type, bool isBack);
+    void pushQuad(std::vector<Vertex>& out, int axis, int x[3], int w, int h, int u, int v, BlockType type, bool isBack) const;
     
 };
\ No newline at end of file
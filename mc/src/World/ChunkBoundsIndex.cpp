@@ -0,0 +1,70 @@
+#include "ChunkBoundsIndex.hpp"
+#include "Chunk.hpp"
+#include <algorithm>
+#include <bit>
+
+void ChunkBoundsIndex::insert(Chunk* chunk, int cx, int cz) {
+    int gx = cx >> GROUP_SHIFT, gz = cz >> GROUP_SHIFT;
+    auto [it, added] = groupIndex.try_emplace(groupKey(gx, gz), (int)groups.size());
+    if (added) {
+        const float side = float(CHUNK_W << GROUP_SHIFT);
+        Group g;
+        g.gx = gx;
+        g.gz = gz;
+        g.bounds.min = glm::vec3(gx * side, 0.0f, gz * side);
+        g.bounds.max = g.bounds.min + glm::vec3(side, float(CHUNK_H), side);
+        groups.push_back(std::move(g));
+    }
+    Group& g = groups[it->second];
+    g.boxes.push(chunk->aabb);
+    g.chunks.push_back(chunk);
+}
+
+void ChunkBoundsIndex::erase(Chunk* chunk, int cx, int cz) {
+    auto it = groupIndex.find(groupKey(cx >> GROUP_SHIFT, cz >> GROUP_SHIFT));
+    if (it == groupIndex.end()) return;
+    Group& g = groups[it->second];
+    auto pos = std::find(g.chunks.begin(), g.chunks.end(), chunk);
+    if (pos == g.chunks.end()) return;
+    int i = (int)(pos - g.chunks.begin());
+    g.boxes.removeSwap(i);
+    *pos = g.chunks.back();
+    g.chunks.pop_back();
+    if (!g.chunks.empty()) return;
+
+    // 组空了：用最后一组填补
+    int index = it->second;
+    groupIndex.erase(it);
+    if (index != (int)groups.size() - 1) {
+        groups[index] = std::move(groups.back());
+        groupIndex[groupKey(groups[index].gx, groups[index].gz)] = index;
+    }
+    groups.pop_back();
+}
+
+void ChunkBoundsIndex::cull(const Frustum& frustum, std::vector<Chunk*>& out) const {
+    groupsRejected = groupsAccepted = groupsTested = chunksTested = 0;
+    // 每组最多 4x4 个区块 (坐标互不相同)
+    constexpr int maxChunks = 1 << (2 * GROUP_SHIFT);
+    uint8_t masks[(maxChunks + AABBList::BATCH - 1) / AABBList::BATCH];
+
+    for (const Group& g : groups) {
+        switch (frustum.classifyBox(g.bounds)) {
+        case Frustum::Containment::Outside:
+            groupsRejected++;
+            break;
+        case Frustum::Containment::Inside:
+            groupsAccepted++;
+            out.insert(out.end(), g.chunks.begin(), g.chunks.end());
+            break;
+        case Frustum::Containment::Intersecting:
+            groupsTested++;
+            chunksTested += g.boxes.count;
+            frustum.testBoxes(g.boxes, masks);
+            for (int b = 0; b < g.boxes.batches(); ++b)
+                for (unsigned m = masks[b]; m; m &= m - 1)
+                    out.push_back(g.chunks[b * AABBList::BATCH + std::countr_zero(m)]);
+            break;
+        }
+    }
+}
@@ -0,0 +1,39 @@
+#pragma once
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+#include "../Math/Frustum.hpp"
+
+class Chunk;
+
+// 已加载区块的包围盒，按 4x4 区块一组存成 SoA，视锥剔除分两级：
+// 先测组的包围盒，整组在外直接跳过、整组在内全部接受，只有与视锥边界相交的组才逐个区块批量测试 (AVX 一次 8 个)
+// 渲染距离 32 时有四千多个区块，逐个遍历哈希表做 6 次标量平面测试是每帧的固定开销
+class ChunkBoundsIndex {
+public:
+    static constexpr int GROUP_SHIFT = 2; // 组边长 1 << GROUP_SHIFT 个区块
+
+    void insert(Chunk* chunk, int cx, int cz);
+    void erase(Chunk* chunk, int cx, int cz);
+
+    // 视锥内的区块追加到 out (顺序为组内存放顺序，不保证稳定)
+    void cull(const Frustum& frustum, std::vector<Chunk*>& out) const;
+
+    // 统计 (最近一次 cull)
+    mutable int groupsRejected = 0;    // 整组在视锥外
+    mutable int groupsAccepted = 0;    // 整组在视锥内
+    mutable int groupsTested = 0;      // 与边界相交、逐个区块测试的组
+    mutable int chunksTested = 0;
+
+private:
+    struct Group {
+        int gx, gz;
+        AABB bounds;              // 整个 4x4 区域 (不论是否加载满)
+        AABBList boxes;           // 与 chunks 一一对应
+        std::vector<Chunk*> chunks;
+    };
+    std::vector<Group> groups;
+    std::unordered_map<uint64_t, int> groupIndex; // (gx, gz) -> groups 下标
+
+    static uint64_t groupKey(int gx, int gz) { return ((uint64_t)(uint32_t)gx << 32) | (uint32_t)gz; }
+};
@@ -0,0 +1,25 @@
+#include "ChunkGrid.hpp"
+
+void ChunkGrid::reset(int size) {
+    int n = 1;
+    shift = 0;
+    while (n < size) { n <<= 1; ++shift; }
+    mask = n - 1;
+    slots.assign((size_t)n * n, Slot{});
+}
+
+bool ChunkGrid::insert(int cx, int cz, Chunk* chunk) {
+    Slot& s = slots[slotIndex(cx, cz)];
+    if (s.chunk && s.chunk != chunk) return false;
+    s.x = cx;
+    s.z = cz;
+    s.chunk = chunk;
+    return true;
+}
+
+bool ChunkGrid::erase(int cx, int cz, const Chunk* chunk) {
+    Slot& s = slots[slotIndex(cx, cz)];
+    if (s.chunk != chunk || s.x != cx || s.z != cz) return false;
+    s.chunk = nullptr;
+    return true;
+}
@@ -0,0 +1,37 @@
+#pragma once
+#include <cstddef>
+#include <vector>
+
+class Chunk;
+
+// 环形区块网格：N x N 个槽 (N 为 2 的幂)，区块 (cx, cz) 放在 (cx mod N, cz mod N)
+// 加载范围不超过 N 个区块宽时互不冲突，查找只需一次取模下标 + 坐标比较，不走哈希与链表
+// 槽被占用时插入失败，由调用方 (World) 放在哈希表里兜底
+class ChunkGrid {
+public:
+    // 重新分配为 size x size 个空槽 (size 向上取整到 2 的幂)
+    void reset(int size);
+    int size() const { return mask + 1; }
+
+    Chunk* find(int cx, int cz) const {
+        const Slot& s = slots[slotIndex(cx, cz)];
+        return (s.x == cx && s.z == cz) ? s.chunk : nullptr;
+    }
+    // 槽已被其他区块占用时返回 false
+    bool insert(int cx, int cz, Chunk* chunk);
+    // 槽中确实是该区块时清空，返回是否清空
+    bool erase(int cx, int cz, const Chunk* chunk);
+    // (cx, cz) 所在的槽是否空闲
+    bool isFree(int cx, int cz) const { return slots[slotIndex(cx, cz)].chunk == nullptr; }
+
+private:
+    struct Slot {
+        int x = 0, z = 0;
+        Chunk* chunk = nullptr;
+    };
+    std::vector<Slot> slots = std::vector<Slot>(1);
+    int mask = 0;
+    int shift = 0;
+
+    int slotIndex(int cx, int cz) const { return ((cz & mask) << shift) | (cx & mask); }
+};
@@ -0,0 +1,58 @@
+#include "ChunkPool.hpp"
+#include <algorithm>
+
+std::unique_ptr<Chunk> ChunkPool::acquire(int x, int z) {
+    std::unique_ptr<Chunk> chunk;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (free.empty()) {
+            counters.allocations++;
+        } else {
+            chunk = std::move(free.back());
+            free.pop_back();
+            counters.reuses++;
+        }
+    }
+    // 构造 / 清空都在锁外
+    if (!chunk) return std::make_unique<Chunk>(x, z);
+    chunk->reset(x, z);
+    return chunk;
+}
+
+void ChunkPool::release(std::unique_ptr<Chunk> chunk) {
+    if (!chunk) return;
+    std::lock_guard<std::mutex> lock(mutex);
+    if (free.size() >= highWaterMark) {
+        counters.discarded++;
+        return; // chunk 离开作用域时释放
+    }
+    free.push_back(std::move(chunk));
+    counters.released++;
+    counters.peakPooled = std::max(counters.peakPooled, free.size());
+}
+
+void ChunkPool::setHighWaterMark(size_t count) {
+    std::vector<std::unique_ptr<Chunk>> excess;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        highWaterMark = count;
+        // 多出来的移到锁外释放
+        while (free.size() > highWaterMark) {
+            excess.push_back(std::move(free.back()));
+            free.pop_back();
+            counters.discarded++;
+        }
+    }
+}
+
+size_t ChunkPool::getHighWaterMark() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return highWaterMark;
+}
+
+ChunkPool::Stats ChunkPool::stats() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    Stats s = counters;
+    s.pooled = free.size();
+    return s;
+}
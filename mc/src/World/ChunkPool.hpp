@@ -0,0 +1,39 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include "Chunk.hpp"
+
+// 卸载区块的回收池：Chunk 对象连同各段的调色板 / 下标数组、网格布局与待上传网格的缓冲容量一起保留，
+// 下一个加载的区块直接复用 (Chunk::reset)，流式移动时区块存储不再反复分配、释放堆内存
+// 池中最多保留 highWaterMark 个，超出的直接释放 (瞬移等一次卸载大量区块时不会一直占着内存)
+// acquire 由加载线程调用、release 由主线程调用，内部加锁
+class ChunkPool {
+public:
+    explicit ChunkPool(size_t highWaterMark = 128) : highWaterMark(highWaterMark) {}
+
+    // 取一个空区块 (全空气，坐标为 x, z)，池空时才新分配
+    std::unique_ptr<Chunk> acquire(int x, int z);
+    void release(std::unique_ptr<Chunk> chunk);
+
+    void setHighWaterMark(size_t count);
+    size_t getHighWaterMark() const;
+
+    struct Stats {
+        uint64_t allocations = 0; // 池空、新分配的区块
+        uint64_t reuses = 0;      // 从池中取出复用
+        uint64_t released = 0;    // 放回池中
+        uint64_t discarded = 0;   // 池满直接释放
+        size_t pooled = 0;        // 当前池中数量
+        size_t peakPooled = 0;
+    };
+    Stats stats() const;
+
+private:
+    mutable std::mutex mutex;
+    std::vector<std::unique_ptr<Chunk>> free;
+    size_t highWaterMark;
+    Stats counters;
+};
@@ -0,0 +1,67 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <vector>
+#include "BlockType.hpp"
+
+// 网格构建用的方块快照：区块本体 + 水平方向 1 格邻居 (halo)
+// 后台线程只读快照，不再直接访问区块存储；y 超出范围视为空气
+template <int W, int H, int SH>
+struct BasicChunkSnapshot {
+    static constexpr int PW = W + 2; // 含 halo 的宽度
+
+    std::vector<BlockType> cells = std::vector<BlockType>(PW * H * PW, AIR); // 布局 [x+1][y][z+1]
+    // 第 s 段 (y 属于 [s*SH, (s+1)*SH)) 连同 halo 全是同一种方块：段内没有任何面，网格构建整段跳过
+    std::array<bool, H / SH> closed{};
+
+    bool isClosedAt(int y) const { return closed[y / SH]; }
+
+    // 细节级别 (由 World::buildSnapshot 按区块当前的 lod 填写)，见 applyLod
+    int lod = 0;
+
+    static int index(int x, int y, int z) { return ((x + 1) * H + y) * PW + (z + 1); }
+
+    // x, z 取值 [-1, W]，y 取值任意
+    BlockType at(int x, int y, int z) const {
+        if (y < 0 || y >= H) return AIR;
+        return cells[index(x, y, z)];
+    }
+    void set(int x, int y, int z, BlockType type) { cells[index(x, y, z)] = type; }
+
+    // 区块本体按 s x s x s (s = 2^lod) 的块降采样，再原样铺回原分辨率：网格构建照常进行，
+    // 块内的面全部相同，被合并成 s 对齐的大四边形，地表面数约降为 1/s^2；halo 不变
+    // (同 lod 的邻居在 buildSnapshot 中已按同样规则降采样填好，见 downsampleBlock)
+    // 单值段降采样后不变，closed 标记仍然成立
+    void applyLod() {
+        const int s = 1 << lod;
+        if (s == 1) return;
+        auto get = [&](int x, int y, int z) { return cells[index(x, y, z)]; };
+        for (int x0 = 0; x0 < W; x0 += s)
+            for (int z0 = 0; z0 < W; z0 += s)
+                for (int y0 = 0; y0 < H; y0 += s) {
+                    BlockType t = downsampleBlock(x0, y0, z0, s, get);
+                    for (int y = y0; y < y0 + s; ++y)
+                        for (int x = x0; x < x0 + s; ++x)
+                            std::fill_n(&cells[index(x, y, z0)], s, t);
+                }
+    }
+
+    // 以 (x0, y0, z0) 为起点的 s x s x s 块降采样后的方块，get(x, y, z) 读取原始方块 (区块内坐标)：
+    // 实心过半取最高处的实心方块 (地表保留草地颜色)，否则有水且水 + 实心过半取水，其余为空气
+    template <class Get>
+    static BlockType downsampleBlock(int x0, int y0, int z0, int s, Get&& get) {
+        int solid = 0, water = 0;
+        BlockType top = AIR;
+        for (int y = y0; y < y0 + s; ++y)
+            for (int x = x0; x < x0 + s; ++x)
+                for (int z = z0; z < z0 + s; ++z) {
+                    BlockType b = get(x, y, z);
+                    if (b == WATER) water++;
+                    else if (b != AIR) { solid++; top = b; }
+                }
+        const int n = s * s * s;
+        if (solid * 2 >= n) return top;
+        if (water > 0 && (solid + water) * 2 >= n) return WATER;
+        return AIR;
+    }
+};
@@ -0,0 +1,249 @@
+#include "RegionFile.hpp"
+#include "Chunk.hpp"
+#include <cstring>
+#include <filesystem>
+#include "../Core/Profiler.hpp"
+
+// ---------------- 编解码 ----------------
+
+static void putVarint(std::vector<uint8_t>& out, uint32_t v) {
+    while (v >= 0x80) { out.push_back((uint8_t)(v | 0x80)); v >>= 7; }
+    out.push_back((uint8_t)v);
+}
+
+static bool getVarint(const uint8_t*& p, const uint8_t* end, uint32_t& v) {
+    v = 0;
+    for (int shift = 0; p < end && shift < 35; shift += 7) {
+        uint8_t b = *p++;
+        v |= (uint32_t)(b & 0x7F) << shift;
+        if (!(b & 0x80)) return true;
+    }
+    return false;
+}
+
+void RegionFile::encode(const BlockType* blocks, std::vector<uint8_t>& out) {
+    // 按竖直列展开，地形的一列通常只有 3~4 段 (泥土/草/水/空气)
+    out.clear();
+    BlockType run = blocks[Chunk::index(0, 0, 0)];
+    uint32_t count = 0;
+    for (int x = 0; x < CHUNK_W; ++x)
+        for (int z = 0; z < CHUNK_W; ++z)
+            for (int y = 0; y < CHUNK_H; ++y) {
+                BlockType b = blocks[Chunk::index(x, y, z)];
+                if (b == run) { ++count; continue; }
+                putVarint(out, count);
+                out.push_back(run);
+                run = b;
+                count = 1;
+            }
+    putVarint(out, count);
+    out.push_back(run);
+}
+
+bool RegionFile::decode(const uint8_t* data, size_t size, BlockType* out) {
+    const uint8_t* p = data;
+    const uint8_t* end = data + size;
+    int x = 0, z = 0, y = 0;
+    int written = 0;
+    while (written < CHUNK_VOLUME) {
+        uint32_t count;
+        if (!getVarint(p, end, count) || p >= end) return false;
+        BlockType type = (BlockType)*p++;
+        if (count == 0 || written + (int)count > CHUNK_VOLUME) return false;
+        written += (int)count;
+        while (count--) {
+            out[Chunk::index(x, y, z)] = type;
+            if (++y == CHUNK_H) { y = 0; if (++z == CHUNK_W) { z = 0; ++x; } }
+        }
+    }
+    return true;
+}
+
+// ---------------- RegionFile ----------------
+
+RegionFile::RegionFile(std::string filePath) : path(std::move(filePath)) {
+    // 已有文件：从映射中读出偏移表
+    if (mapping.open(path) && mapping.size() >= HEADER_SIZE && std::memcmp(mapping.data(), "MCRG", 4) == 0) {
+        uint32_t version;
+        std::memcpy(&version, mapping.data() + 4, 4);
+        if (version == VERSION) {
+            std::memcpy(table, mapping.data() + 8, sizeof(table));
+            fileEnd = mapping.size();
+            mappingStale = false;
+            headerValid = true;
+            return;
+        }
+    }
+    mapping.close();
+}
+
+bool RegionFile::read(int lx, int lz, BlockType* out) {
+    std::lock_guard<std::mutex> lock(mutex);
+    const Entry& e = table[lx * REGION_SIZE + lz];
+    if (e.length == 0) return false;
+
+    if (mappingStale || mapping.size() < (size_t)e.offset + e.length) {
+        if (writer.is_open()) writer.flush();
+        if (!mapping.open(path)) return false;
+        mappingStale = false;
+    }
+    if (mapping.size() < (size_t)e.offset + e.length) return false;
+    return decode(mapping.data() + e.offset, e.length, out);
+}
+
+bool RegionFile::openWriter() {
+    if (writer.is_open()) return true;
+    if (!headerValid) {
+        // 文件头损坏、版本不符或文件过短：旧文件改名留作排查 (改名失败时下面直接截断)，重建后按新文件处理
+        std::error_code ec;
+        if (std::filesystem::exists(path, ec)) std::filesystem::rename(path, path + ".bad", ec);
+        // 新文件：写入空的文件头
+        std::ofstream create(path, std::ios::binary | std::ios::trunc);
+        uint32_t version = VERSION;
+        create.write("MCRG", 4);
+        create.write(reinterpret_cast<const char*>(&version), 4);
+        create.write(reinterpret_cast<const char*>(table), sizeof(table));
+        if (!create) return false;
+        fileEnd = HEADER_SIZE;
+        headerValid = true;
+    }
+    writer.open(path, std::ios::in | std::ios::out | std::ios::binary);
+    return writer.is_open();
+}
+
+void RegionFile::write(int lx, int lz, const std::vector<uint8_t>& payload) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!openWriter()) return;
+
+    int i = lx * REGION_SIZE + lz;
+    Entry& e = table[i];
+    if (payload.size() > e.capacity) {
+        // 放不下：追加到末尾，预留一点余量给之后的编辑
+        e.offset = (uint32_t)fileEnd;
+        e.capacity = (uint32_t)((payload.size() + 255) & ~size_t(255));
+        fileEnd += e.capacity;
+        mappingStale = true;
+    }
+    e.length = (uint32_t)payload.size();
+
+    writer.seekp(e.offset);
+    writer.write(reinterpret_cast<const char*>(payload.data()), payload.size());
+    if (e.capacity > payload.size()) {
+        static const char zeros[256] = {};
+        writer.write(zeros, e.capacity - payload.size());
+    }
+    writer.seekp(8 + sizeof(Entry) * i);
+    writer.write(reinterpret_cast<const char*>(&e), sizeof(Entry));
+    writer.flush();
+}
+
+// ---------------- RegionStore ----------------
+
+static uint64_t coordKey(int cx, int cz) { return ((uint64_t)(uint32_t)cx << 32) | (uint32_t)cz; }
+static int floorDiv(int a, int b) { return (a >= 0) ? a / b : (a - b + 1) / b; }
+
+RegionStore::RegionStore(std::string dir) : directory(std::move(dir)) {
+    std::filesystem::create_directories(directory);
+    writerThread = std::thread(&RegionStore::writerLoop, this);
+}
+
+RegionStore::~RegionStore() {
+    flush();
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        stopping = true;
+    }
+    queueChanged.notify_all();
+    writerThread.join();
+}
+
+std::shared_ptr<RegionFile> RegionStore::region(int cx, int cz, int& lx, int& lz) {
+    int rx = floorDiv(cx, REGION_SIZE), rz = floorDiv(cz, REGION_SIZE);
+    lx = cx - rx * REGION_SIZE;
+    lz = cz - rz * REGION_SIZE;
+
+    std::lock_guard<std::mutex> lock(regionMutex);
+    auto [it, inserted] = regions.try_emplace({rx, rz});
+    if (inserted) {
+        std::string file = directory + "/r." + std::to_string(rx) + "." + std::to_string(rz) + ".mcr";
+        it->second.file = std::make_shared<RegionFile>(file);
+    }
+    it->second.lastUsed = ++regionClock;
+    std::shared_ptr<RegionFile> result = it->second.file;
+    if (inserted) closeIdleRegions();
+    return result;
+}
+
+void RegionStore::closeIdleRegions() {
+    // 只关闭没有线程持有的 (use_count 为 1，新的持有者须先拿 regionMutex)：
+    // 写入在返回前已 flush，下次用到时重新打开读到的就是最新的偏移表
+    while (regions.size() > MAX_OPEN_REGIONS) {
+        auto victim = regions.end();
+        for (auto it = regions.begin(); it != regions.end(); ++it)
+            if (it->second.file.use_count() == 1 && (victim == regions.end() || it->second.lastUsed < victim->second.lastUsed))
+                victim = it;
+        if (victim == regions.end()) return; // 都在用，暂时超出上限
+        regions.erase(victim);
+    }
+}
+
+bool RegionStore::load(int cx, int cz, ChunkBlocks& out) {
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        auto it = pending.find(coordKey(cx, cz));
+        if (it != pending.end()) { out = it->second.blocks; return true; }
+    }
+    int lx, lz;
+    std::shared_ptr<RegionFile> file = region(cx, cz, lx, lz);
+    thread_local std::vector<BlockType> flat(CHUNK_VOLUME);
+    if (!file->read(lx, lz, flat.data())) return false;
+    out.pack(flat.data());
+    return true;
+}
+
+void RegionStore::save(int cx, int cz, const ChunkBlocks& blocks) {
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        pending.insert_or_assign(coordKey(cx, cz), Pending{cx, cz, blocks, nextVersion++});
+    }
+    queueChanged.notify_all();
+}
+
+void RegionStore::flush() {
+    std::unique_lock<std::mutex> lock(queueMutex);
+    queueChanged.wait(lock, [&] { return pending.empty(); });
+}
+
+size_t RegionStore::pendingWrites() const {
+    std::lock_guard<std::mutex> lock(queueMutex);
+    return pending.size();
+}
+
+void RegionStore::writerLoop() {
+    Profiler::get().setThreadName("region writer");
+    std::vector<BlockType> flat(CHUNK_VOLUME);
+    std::vector<uint8_t> payload;
+    std::unique_lock<std::mutex> lock(queueMutex);
+    while (true) {
+        queueChanged.wait(lock, [&] { return stopping || !pending.empty(); });
+        if (pending.empty()) return; // stopping 且已写完
+
+        // 拷贝出来再写，写完之前条目留在队列里，load 仍能读到最新数据
+        uint64_t key = pending.begin()->first;
+        Pending job = pending.begin()->second;
+        lock.unlock();
+
+        {
+            PROFILE_SCOPE("save chunk", "save");
+            job.blocks.unpack(flat.data());
+            RegionFile::encode(flat.data(), payload);
+            int lx, lz;
+            region(job.cx, job.cz, lx, lz)->write(lx, lz, payload);
+        }
+
+        lock.lock();
+        auto it = pending.find(key);
+        if (it != pending.end() && it->second.version == job.version) pending.erase(it);
+        queueChanged.notify_all();
+    }
+}
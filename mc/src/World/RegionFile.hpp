@@ -0,0 +1,93 @@
+#pragma once
+#include <condition_variable>
+#include <cstdint>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include "Chunk.hpp"
+#include "../Core/MappedFile.hpp"
+
+// 区域文件：一个文件保存 REGION_SIZE x REGION_SIZE 个区块
+//  文件头: "MCRG" + u32 版本 + 偏移表 [REGION_SIZE^2] { u32 offset, u32 length, u32 capacity }
+//  区块数据: 按列 (x, z, y 由低到高) 展开后做 RLE，每段为 varint 长度 + 1 字节方块类型
+// 读取走内存映射；写入由 RegionStore 的后台线程完成，放得下就原地覆盖，放不下追加到文件末尾
+// 数值按小端序直接写入
+constexpr int REGION_SIZE = 32;
+
+class RegionFile {
+public:
+    explicit RegionFile(std::string path);
+
+    // lx, lz 为区域内的区块坐标；读到 out (CHUNK_VOLUME 个方块，布局同 Chunk::index)
+    bool read(int lx, int lz, BlockType* out);
+    void write(int lx, int lz, const std::vector<uint8_t>& payload);
+
+    static void encode(const BlockType* blocks, std::vector<uint8_t>& out);
+    static bool decode(const uint8_t* data, size_t size, BlockType* out);
+
+private:
+    struct Entry { uint32_t offset = 0, length = 0, capacity = 0; };
+    static constexpr uint32_t VERSION = 1;
+    static constexpr size_t HEADER_SIZE = 8 + sizeof(Entry) * REGION_SIZE * REGION_SIZE;
+
+    std::mutex mutex;
+    std::string path;
+    MappedFile mapping;
+    bool mappingStale = true;   // 文件变长后需要重新映射
+    bool headerValid = false;   // 文件存在且文件头可用；否则首次写入前重建文件
+    std::fstream writer;
+    uint64_t fileEnd = HEADER_SIZE;
+    Entry table[REGION_SIZE * REGION_SIZE];
+
+    bool openWriter();
+};
+
+// 按区块坐标读写区域文件，写入在后台线程压缩并落盘
+class RegionStore {
+public:
+    explicit RegionStore(std::string directory);
+    ~RegionStore();
+
+    // 可在任意线程调用；排队中尚未落盘的数据优先返回
+    bool load(int cx, int cz, ChunkBlocks& out);
+    // 拷贝一份压缩存储排队写入，同一区块多次提交只写最新的
+    void save(int cx, int cz, const ChunkBlocks& blocks);
+    // 阻塞到队列清空
+    void flush();
+    size_t pendingWrites() const;
+
+private:
+    struct Pending {
+        int cx, cz;
+        ChunkBlocks blocks;
+        uint64_t version;
+    };
+
+    // 同时打开的区域文件上限 (每个占一个映射和一个文件句柄)，超出时关闭最久未用且没有线程在用的
+    static constexpr size_t MAX_OPEN_REGIONS = 16;
+    struct OpenRegion {
+        std::shared_ptr<RegionFile> file;
+        uint64_t lastUsed;
+    };
+
+    std::string directory;
+    std::mutex regionMutex;
+    std::map<std::pair<int, int>, OpenRegion> regions;
+    uint64_t regionClock = 0;
+    // 返回的指针在使用期间保持文件打开；同一区域同时只有一个 RegionFile 实例
+    std::shared_ptr<RegionFile> region(int cx, int cz, int& lx, int& lz);
+    void closeIdleRegions(); // 调用方须持有 regionMutex
+
+    mutable std::mutex queueMutex;
+    std::condition_variable queueChanged;
+    std::unordered_map<uint64_t, Pending> pending;
+    uint64_t nextVersion = 0;
+    bool stopping = false;
+    std::thread writerThread;
+    void writerLoop();
+};
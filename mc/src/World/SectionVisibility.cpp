@@ -0,0 +1,81 @@
+#include "SectionVisibility.hpp"
+#include <cassert>
+#include <cstddef>
+#include <vector>
+
+static bool isPassable(BlockType b) { return b == AIR || b == WATER; }
+
+SectionVisibility SectionVisibility::compute(const BlockType* cells, int sizeX, int sizeY, int sizeZ) {
+    // 按行位并行填充：每个 (x, y) 的一行 z 存成一个 64 位掩码，行内一次扩展整段，行间按掩码相与传播
+    // (编辑后主线程要重算所在段，逐格填充上万个格子太慢)
+    assert(sizeZ <= 64);
+    const int rows = sizeX * sizeY;
+    const uint64_t full = sizeZ == 64 ? ~0ull : (1ull << sizeZ) - 1;
+    const uint64_t lastBit = 1ull << (sizeZ - 1);
+
+    thread_local std::vector<uint64_t> open, visited, pending;
+    thread_local std::vector<int> work;
+    open.assign(rows, 0);
+    visited.assign(rows, 0);
+    pending.assign(rows, 0);
+
+    // 行下标 r = x * sizeY + y
+    int openRows = 0, solidRows = 0;
+    for (int r = 0; r < rows; ++r) {
+        const BlockType* row = cells + (size_t)r * sizeZ;
+        uint64_t m = 0;
+        for (int z = 0; z < sizeZ; ++z) m |= (uint64_t)isPassable(row[z]) << z;
+        open[r] = m;
+        openRows += m == full;
+        solidRows += m == 0;
+    }
+    // 整段都不是实心 / 都是实心时不必填充
+    if (openRows == rows) return {};
+    SectionVisibility vis = none();
+    if (solidRows == rows) return vis;
+
+    for (int seedRow = 0; seedRow < rows; ++seedRow) {
+        while (uint64_t remaining = open[seedRow] & ~visited[seedRow]) {
+            // 一个连通分量碰到的所有面两两连通
+            uint8_t faces = 0;
+            pending[seedRow] = remaining & (~remaining + 1);
+            work.clear();
+            work.push_back(seedRow);
+            while (!work.empty()) {
+                int r = work.back();
+                work.pop_back();
+                uint64_t avail = open[r] & ~visited[r];
+                uint64_t m = pending[r] & avail;
+                pending[r] = 0;
+                if (!m) continue;
+                // 行内沿 z 扩展到相连的所有可通行格子
+                for (uint64_t grown; (grown = (m | (m << 1) | (m >> 1)) & avail) != m; ) m = grown;
+                visited[r] |= m;
+
+                int x = r / sizeY, y = r % sizeY;
+                if (x == sizeX - 1) faces |= 1 << 0;
+                if (x == 0)         faces |= 1 << 1;
+                if (y == sizeY - 1) faces |= 1 << 2;
+                if (y == 0)         faces |= 1 << 3;
+                if (m & lastBit)    faces |= 1 << 4;
+                if (m & 1)          faces |= 1 << 5;
+
+                auto spread = [&](int q) {
+                    uint64_t add = m & open[q] & ~visited[q];
+                    if (!add) return;
+                    if (!pending[q]) work.push_back(q);
+                    pending[q] |= add;
+                };
+                if (x + 1 < sizeX) spread(r + sizeY);
+                if (x > 0)         spread(r - sizeY);
+                if (y + 1 < sizeY) spread(r + 1);
+                if (y > 0)         spread(r - 1);
+            }
+
+            for (int f = 0; f < 6; ++f)
+                if (faces & (1 << f)) vis.reach[f] |= faces;
+            if (vis.isOpen()) return vis; // 已全连通，剩下的分量不会再增加什么
+        }
+    }
+    return vis;
+}
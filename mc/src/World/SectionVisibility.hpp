@@ -0,0 +1,23 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include "BlockType.hpp"
+
+// 段内的面-面连通性 (洞穴剔除用)：从段的 a 面进入后，能否只经过非实心格子 (空气/水) 从 b 面出去
+// 面编号与顶点法线一致: 0 +X, 1 -X, 2 +Y, 3 -Y, 4 +Z, 5 -Z；相对的面为 face ^ 1
+struct SectionVisibility {
+    // reach[a] 的第 b 位：a 面与 b 面连通；默认任意两面都连通 (尚未计算的段按此处理，只会多画不会漏画)
+    std::array<uint8_t, 6> reach{0x3F, 0x3F, 0x3F, 0x3F, 0x3F, 0x3F};
+
+    bool connected(int a, int b) const { return (reach[a] >> b) & 1; }
+    bool isOpen() const { return reach == SectionVisibility{}.reach; }
+
+    // 任意两面都不连通 (整段实心)
+    static SectionVisibility none() {
+        SectionVisibility v;
+        v.reach.fill(0);
+        return v;
+    }
+    // 洪水填充求连通性，cells 布局 [x][y][z]，z 变化最快
+    static SectionVisibility compute(const BlockType* cells, int sizeX, int sizeY, int sizeZ);
+};
@@ -1,39 +1,401 @@
 #include "World.hpp"
+#include <algorithm>
+#include <cmath>
+#include <optional>
+#include "../Core/Profiler.hpp"
 
-World::World(const PerlinNoise& noise) : noiseGen(noise) {}
+World::World(const PerlinNoise& noise) : noiseGen(noise) {
+    resizeGrid();
+}
+
+void World::resizeGrid() {
+    // 加载范围直径 2 * (r + margin) + 1，网格边长取不小于它的 2 的幂
+    grid.reset(2 * (renderDistance + unloadMargin) + 1);
+    overflowChunks = 0;
+    for (auto& pair : chunks)
+        if (!grid.insert(pair.first.x, pair.first.z, pair.second.get())) ++overflowChunks;
+}
+
+World::~World() {
+    // 退出前把未保存的区块全部写盘 (RegionStore 析构时等待队列清空)
+    saveModifiedChunks();
+}
+
+void World::enablePersistence(const std::string& directory) {
+    regionStore = std::make_unique<RegionStore>(directory);
+}
+
+void World::saveChunk(const ChunkCoord& c, Chunk& chunk) {
+    if (!regionStore || !chunk.needsSave) return;
+    regionStore->save(c.x, c.z, chunk.blocks);
+    chunk.needsSave = false;
+}
+
+void World::saveModifiedChunks() {
+    for (auto& pair : chunks) saveChunk(pair.first, *pair.second);
+}
+
+std::unique_ptr<Chunk> World::loadOrGenerate(int x, int z) {
+    std::unique_ptr<Chunk> chunk = chunkPool.acquire(x, z);
+    if (regionStore) {
+        PROFILE_SCOPE("load chunk", "load");
+        if (regionStore->load(x, z, chunk->blocks)) return chunk;
+    }
+    PROFILE_SCOPE("generate chunk", "load");
+    chunk->generate(noiseGen);
+    return chunk;
+}
 
 void World::addChunk(int x, int z) {
-    chunks[{x, z}] = std::make_unique<Chunk>(x, z, noiseGen);
+    removeChunk(x, z);
+    insertChunk(x, z, loadOrGenerate(x, z));
+}
+
+void World::insertChunk(int x, int z, std::unique_ptr<Chunk> chunk) {
+    // 读取 / 生成都在锁外完成，只有插入哈希表时才需要独占
+    chunk->lod = lodFor(chunkDistance(x, z));
+    loadedChunksTotal++;
+    {
+        std::unique_lock<std::shared_mutex> lock(chunkMutex);
+        if (!grid.insert(x, z, chunk.get())) ++overflowChunks;
+        boundsIndex.insert(chunk.get(), x, z);
+        chunks[{x, z}] = std::move(chunk);
+    }
+    markDirty(x, z);
+    // 邻居之前把这一侧当成空气，生成了边界墙面，需要重建
+    markNeighborsDirty(x, z);
+}
+
+void World::removeChunk(int x, int z) {
+    auto it = chunks.find({x, z});
+    if (it == chunks.end()) return;
+
+    // 丢弃排队中的网格任务；正在执行的不等，区块留到任务结束再回收
+    uint64_t key = chunkKey(x, z);
+    meshJobs.cancelQueued(key);
+    unloadedChunksTotal++;
+    if (onChunkRemoved) onChunkRemoved(*it->second);
+    saveChunk(it->first, *it->second);
+    std::unique_ptr<Chunk> removed = std::move(it->second);
+    {
+        std::unique_lock<std::shared_mutex> lock(chunkMutex);
+        Chunk* chunk = removed.get();
+        bool inGrid = grid.erase(x, z, chunk);
+        boundsIndex.erase(chunk, x, z);
+        chunks.erase(it);
+        if (!inGrid) {
+            --overflowChunks;
+        } else if (overflowChunks > 0) {
+            // 空出的槽交给映射到这里的溢出区块
+            for (auto& pair : chunks) {
+                const ChunkCoord& c = pair.first;
+                if (grid.find(c.x, c.z) != pair.second.get() && grid.isFree(c.x, c.z) &&
+                    grid.insert(c.x, c.z, pair.second.get())) {
+                    --overflowChunks;
+                    break;
+                }
+            }
+        }
+    }
+    // 存档已拷贝走；没有网格任务在读时直接回收
+    if (meshJobs.busy(key)) retiredChunks.emplace_back(key, std::move(removed));
+    else chunkPool.release(std::move(removed));
+    // 邻居在这一侧失去 halo，重建以补上边界面
+    markNeighborsDirty(x, z);
+}
+
+void World::reclaimRetiredChunks() {
+    // 同一坐标重新加载后会提交新的网格任务，busy 可能因此多持续几帧，只是回收得晚一点
+    for (size_t i = 0; i < retiredChunks.size(); ) {
+        if (meshJobs.busy(retiredChunks[i].first)) { ++i; continue; }
+        chunkPool.release(std::move(retiredChunks[i].second));
+        retiredChunks[i] = std::move(retiredChunks.back());
+        retiredChunks.pop_back();
+    }
+}
+
+void World::markNeighborsDirty(int cx, int cz) {
+    markDirty(cx - 1, cz);
+    markDirty(cx + 1, cz);
+    markDirty(cx, cz - 1);
+    markDirty(cx, cz + 1);
+}
+
+void World::buildSnapshot(int cx, int cz, ChunkSnapshot& snap) const {
+    // 持锁期间只拷贝压缩存储和邻居的边界列，解包放到锁外，主线程写方块时几乎不用等待
+    std::optional<ChunkBlocks> self;
+    {
+        std::shared_lock<std::shared_mutex> lock(chunkMutex);
+
+        // 两侧精度相同时 halo 取邻居的方块 (降采样的取邻居降采样后的结果)；精度不同的边界按空气处理，
+        // 两边各自生成边界墙面 (裙边)，遮住精度不同造成的高度差缝隙
+        const Chunk* c = findChunk(cx, cz);
+        if (c) {
+            self = c->blocks;
+            snap.lod = c->lod;
+        }
+        auto find = [&](int x, int z) -> const Chunk* {
+            const Chunk* n = findChunk(x, z);
+            return n && n->lod == snap.lod ? n : nullptr;
+        };
+
+        const Chunk* negX = find(cx - 1, cz);
+        const Chunk* posX = find(cx + 1, cz);
+        const Chunk* negZ = find(cx, cz - 1);
+        const Chunk* posZ = find(cx, cz + 1);
+        if (snap.lod == 0) {
+            // 四个邻居只取贴边的一列 (角上的格子网格构建用不到)
+            for (int y = 0; y < CHUNK_H; ++y) {
+                for (int i = 0; i < CHUNK_W; ++i) {
+                    snap.set(-1,      y, i, negX ? negX->getBlock(CHUNK_W - 1, y, i) : AIR);
+                    snap.set(CHUNK_W, y, i, posX ? posX->getBlock(0, y, i) : AIR);
+                    snap.set(i, y, -1,      negZ ? negZ->getBlock(i, y, CHUNK_W - 1) : AIR);
+                    snap.set(i, y, CHUNK_W, posZ ? posZ->getBlock(i, y, 0) : AIR);
+                }
+            }
+        } else {
+            // 贴边的 s 层按 applyLod 的规则降采样，与邻居自己网格里的边界一致
+            const int s = 1 << snap.lod;
+            auto blocksOf = [](const Chunk* n) {
+                return [n](int x, int y, int z) { return n->getBlock(x, y, z); };
+            };
+            for (int y0 = 0; y0 < CHUNK_H; y0 += s) {
+                for (int i0 = 0; i0 < CHUNK_W; i0 += s) {
+                    BlockType t[4] = {
+                        negX ? ChunkSnapshot::downsampleBlock(CHUNK_W - s, y0, i0, s, blocksOf(negX)) : AIR,
+                        posX ? ChunkSnapshot::downsampleBlock(0, y0, i0, s, blocksOf(posX)) : AIR,
+                        negZ ? ChunkSnapshot::downsampleBlock(i0, y0, CHUNK_W - s, s, blocksOf(negZ)) : AIR,
+                        posZ ? ChunkSnapshot::downsampleBlock(i0, y0, 0, s, blocksOf(posZ)) : AIR,
+                    };
+                    for (int y = y0; y < y0 + s; ++y) {
+                        for (int i = i0; i < i0 + s; ++i) {
+                            snap.set(-1,      y, i, t[0]);
+                            snap.set(CHUNK_W, y, i, t[1]);
+                            snap.set(i, y, -1,      t[2]);
+                            snap.set(i, y, CHUNK_W, t[3]);
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    if (self) {
+        thread_local std::vector<BlockType> flat(CHUNK_VOLUME);
+        self->unpack(flat.data());
+        for (int x = 0; x < CHUNK_W; ++x)
+            for (int y = 0; y < CHUNK_H; ++y)
+                std::copy_n(&flat[Chunk::index(x, y, 0)], CHUNK_W, &snap.cells[ChunkSnapshot::index(x, y, 0)]);
+    }
+
+    // 单值段且 halo 也是同一种方块 -> 封闭段，网格构建整段跳过
+    for (int s = 0; s < SECTION_COUNT; ++s) {
+        snap.closed[s] = false;
+        if (!self || !self->sections[s].isUniform()) continue;
+        BlockType t = self->sections[s].uniformType();
+        bool closed = true;
+        for (int y = s * SECTION_H; y < (s + 1) * SECTION_H && closed; ++y) {
+            for (int i = 0; i < CHUNK_W; ++i) {
+                if (snap.at(-1, y, i) != t || snap.at(CHUNK_W, y, i) != t ||
+                    snap.at(i, y, -1) != t || snap.at(i, y, CHUNK_W) != t) { closed = false; break; }
+            }
+        }
+        snap.closed[s] = closed;
+    }
+}
+
+void World::setRenderDistance(int dist) {
+    dist = std::max(dist, 1);
+    if (dist == renderDistance) return;
+    renderDistance = dist;
+    streamingDirty = true;
+    std::unique_lock<std::shared_mutex> lock(chunkMutex);
+    resizeGrid();
+}
+
+void World::updateStreaming(const glm::vec3& playerPos) {
+    int cx = (int)std::floor(playerPos.x / CHUNK_W);
+    int cz = (int)std::floor(playerPos.z / CHUNK_W);
+    if (cx != centerX || cz != centerZ) {
+        centerX = cx;
+        centerZ = cz;
+        streamingDirty = true;
+    }
+    reclaimRetiredChunks();
+    if (streamingDirty) {
+        evictFarChunks();
+        rebuildLoadQueue();
+        updateLods();
+        streamingDirty = false;
+    }
+    {
+        PROFILE_SCOPE("integrate loads");
+        integrateLoadedChunks();
+    }
+    submitLoads();
+}
+
+bool World::inKeepRange(int cx, int cz) const {
+    int r = renderDistance + unloadMargin;
+    int dx = cx - centerX, dz = cz - centerZ;
+    return dx * dx + dz * dz <= r * r;
+}
+
+void World::submitLoads() {
+    while (loadCursor < loadQueue.size() && (int)loading.size() < maxPendingLoads) {
+        ChunkCoord c = loadQueue[loadCursor++];
+        uint64_t key = chunkKey(c.x, c.z);
+        if (findChunk(c.x, c.z) || !loading.insert(key).second) continue;
+        // 队列已按距离排序，优先级只是让先提交的近处区块先执行
+        float priority = float((c.x - centerX) * (c.x - centerX) + (c.z - centerZ) * (c.z - centerZ));
+        loadJobs.submit(key, priority, [this, c] {
+            std::unique_ptr<Chunk> chunk = loadOrGenerate(c.x, c.z);
+            std::lock_guard<std::mutex> lock(loadedMutex);
+            loaded.emplace_back(c, std::move(chunk));
+        });
+    }
+}
+
+void World::integrateLoadedChunks() {
+    {
+        std::lock_guard<std::mutex> lock(loadedMutex);
+        for (auto& entry : loaded) integrating.push_back(std::move(entry));
+        loaded.clear();
+    }
+    if (integrating.empty()) return;
+    // 积压时近的先接入 (中心可能已经移动)
+    std::sort(integrating.begin(), integrating.end(), [this](const auto& a, const auto& b) {
+        return chunkDistance(a.first.x, a.first.z) < chunkDistance(b.first.x, b.first.z);
+    });
+    int inserted = 0;
+    size_t i = 0;
+    for (; i < integrating.size() && inserted < maxIntegrationsPerFrame; ++i) {
+        auto& [c, chunk] = integrating[i];
+        loading.erase(chunkKey(c.x, c.z));
+        // 加载期间玩家已走远 (卸载时已取消但任务正在执行) 的直接丢弃，重新生成的结果相同；丢弃不计入上限
+        if (!inKeepRange(c.x, c.z) || findChunk(c.x, c.z)) {
+            chunkPool.release(std::move(chunk));
+            continue;
+        }
+        insertChunk(c.x, c.z, std::move(chunk));
+        ++inserted;
+    }
+    integrating.erase(integrating.begin(), integrating.begin() + i);
+}
+
+bool World::isAreaReady(const glm::vec3& pos, int radius) const {
+    int cx = (int)std::floor(pos.x / CHUNK_W);
+    int cz = (int)std::floor(pos.z / CHUNK_W);
+    for (int dx = -radius; dx <= radius; ++dx)
+        for (int dz = -radius; dz <= radius; ++dz) {
+            if (dx * dx + dz * dz > radius * radius) continue;
+            const Chunk* chunk = findChunk(cx + dx, cz + dz);
+            if (!chunk || !chunk->hasMesh()) return false;
+            if (!chunk->meshUploaded && (!focusFrustum || focusFrustum->isBoxVisible(chunk->aabb))) return false;
+        }
+    return true;
+}
+
+void World::setLodDistance(int dist) {
+    dist = std::max(dist, 0);
+    if (dist == lodDistance) return;
+    lodDistance = dist;
+    streamingDirty = true;
+}
+
+float World::chunkDistance(int cx, int cz) const {
+    float dx = float(cx - centerX), dz = float(cz - centerZ);
+    return std::sqrt(dx * dx + dz * dz);
+}
+
+int World::lodFor(float dist) const {
+    if (lodDistance <= 0 || dist < lodDistance) return 0;
+    // lodDistance 起 2 倍，2 * lodDistance 起 4 倍，依此类推
+    int lod = 1;
+    while (lod < MAX_LOD && dist >= float(lodDistance << lod)) ++lod;
+    return lod;
+}
+
+void World::updateLods() {
+    for (auto& pair : chunks) {
+        Chunk& chunk = *pair.second;
+        const ChunkCoord& c = pair.first;
+        // 滞回：超过阈值 1 个区块才变粗，回到阈值内 1 个区块才变细，在边界附近来回走动不会反复重建
+        float d = chunkDistance(c.x, c.z);
+        int lod = chunk.lod;
+        if (int coarser = lodFor(d - 1.0f); coarser > lod) lod = coarser;
+        else if (int finer = lodFor(d + 1.0f); finer < lod) lod = finer;
+        if (lod == chunk.lod) continue;
+
+        int oldLod = chunk.lod;
+        {
+            std::unique_lock<std::shared_mutex> lock(chunkMutex);
+            chunk.lod = lod;
+        }
+        // 换精度时轮廓会变 (粗网格可能比原来矮)，上传新网格那一帧渲染器不能用旧深度做遮挡
+        chunk.editedSinceUpload = true;
+        markDirty(c.x, c.z);
+        // 与之前或现在精度相同的邻居，halo 在邻居方块和裙边 (空气) 之间切换，也要重建
+        const int offsets[4][2] = {{-1, 0}, {1, 0}, {0, -1}, {0, 1}};
+        for (const auto& o : offsets) {
+            const Chunk* n = findChunk(c.x + o[0], c.z + o[1]);
+            if (n && (n->lod == oldLod || n->lod == lod)) markDirty(c.x + o[0], c.z + o[1]);
+        }
+    }
+}
+
+void World::rebuildLoadQueue() {
+    loadQueue.clear();
+    loadCursor = 0;
+    int r = renderDistance;
+    for (int dx = -r; dx <= r; ++dx) {
+        for (int dz = -r; dz <= r; ++dz) {
+            if (dx * dx + dz * dz > r * r) continue; // 圆形范围
+            ChunkCoord c{centerX + dx, centerZ + dz};
+            if (!findChunk(c.x, c.z)) loadQueue.push_back(c);
+        }
+    }
+    std::sort(loadQueue.begin(), loadQueue.end(), [&](const ChunkCoord& a, const ChunkCoord& b) {
+        int da = (a.x - centerX) * (a.x - centerX) + (a.z - centerZ) * (a.z - centerZ);
+        int db = (b.x - centerX) * (b.x - centerX) + (b.z - centerZ) * (b.z - centerZ);
+        return da < db;
+    });
+}
+
+void World::evictFarChunks() {
+    std::vector<ChunkCoord> far;
+    for (auto& pair : chunks)
+        if (!inKeepRange(pair.first.x, pair.first.z)) far.push_back(pair.first);
+    for (auto& c : far) removeChunk(c.x, c.z);
+
+    // 还没开始的后台加载直接取消；正在执行的不等 (加载任务只写 loaded 队列)，结果在接入时按距离丢弃
+    for (auto it = loading.begin(); it != loading.end(); ) {
+        int cx = (int)(uint32_t)(*it >> 32), cz = (int)(uint32_t)*it;
+        if (inKeepRange(cx, cz)) { ++it; continue; }
+        loadJobs.cancelQueued(*it);
+        it = loading.erase(it);
+    }
 }
 
 BlockType World::getBlock(int x, int y, int z) {
     if (y < 0 || y >= CHUNK_H) return AIR;
     
-    // 1.计算所属区块坐标
+    // 计算所属区块坐标
     int cx = (x >= 0) ? (x / CHUNK_W) : ((x + 1) / CHUNK_W - 1);
     int cz = (z >= 0) ? (z / CHUNK_W) : ((z + 1) / CHUNK_W - 1);
     
-    // 2. 快速路径：检查缓存
-    if (cx == lastCX && cz == lastCZ && lastAccessedChunk != nullptr) {
-        int lx = x - cx * CHUNK_W;
-        int lz = z - cz * CHUNK_W;
-        return lastAccessedChunk->blocks[lx][y][lz];
-    }
+    Chunk* chunk = findChunk(cx, cz);
+    if (!chunk) return AIR;
+    // 区块内局部坐标
+    return chunk->getBlock(x - cx * CHUNK_W, y, z - cz * CHUNK_W);
+}
 
-    // 3. 慢速路径：查找哈希表
-    auto it = chunks.find({cx, cz});
-    if (it != chunks.end()) {
-        // 更新缓存
-        lastCX = cx;
-        lastCZ = cz;
-        lastAccessedChunk = it->second.get();
-        
-        // 计算区块内局部坐标
-        int lx = x - cx * CHUNK_W;
-        int lz = z - cz * CHUNK_W;
-        return it->second->blocks[lx][y][lz];
-    }
-    return AIR;
+bool World::isSectionEmpty(int x, int y, int z) {
+    if (y < 0 || y >= CHUNK_H) return true;
+    int cx = (x >= 0) ? (x / CHUNK_W) : ((x + 1) / CHUNK_W - 1);
+    int cz = (z >= 0) ? (z / CHUNK_W) : ((z + 1) / CHUNK_W - 1);
+    Chunk* chunk = findChunk(cx, cz);
+    return !chunk || chunk->section(y).isEmpty();
 }
 
 void World::setBlock(int x, int y, int z, BlockType type) {
@@ -42,27 +404,182 @@ void World::setBlock(int x, int y, int z, BlockType type) {
     int cx = (x >= 0) ? (x / CHUNK_W) : ((x + 1) / CHUNK_W - 1);
     int cz = (z >= 0) ? (z / CHUNK_W) : ((z + 1) / CHUNK_W - 1);
 
-    auto it = chunks.find({cx, cz});
-    if (it != chunks.end()) {
+    if (Chunk* chunk = findChunk(cx, cz)) {
         int lx = x - cx * CHUNK_W;
         int lz = z - cz * CHUNK_W;
         
-        // 修改数据
-        it->second->blocks[lx][y][lz] = type;
+        // 修改数据 (调色板扩容会重排数组，需与后台快照读取互斥)
+        {
+            std::unique_lock<std::shared_mutex> lock(chunkMutex);
+            chunk->setBlock(lx, y, lz, type);
+        }
+        chunk->needsSave = true;
+        chunk->editedSinceUpload = true;
+        chunk->dirtySections.set(y / SECTION_H);
         
-        // 重建当前区块网格
-        it->second->rebuild();
+        // 只标记受影响的切面 (方块六个面所在的切面，贴边时还有邻居的一个切面)，本帧末统一处理
+        markSliceDirty(cx, cz, 0, lx);
+        markSliceDirty(cx, cz, 0, lx + 1);
+        markSliceDirty(cx, cz, 1, y);
+        markSliceDirty(cx, cz, 1, y + 1);
+        markSliceDirty(cx, cz, 2, lz);
+        markSliceDirty(cx, cz, 2, lz + 1);
         
-        if (lx == 0) updateChunkMesh(cx - 1, cz);
-        if (lx == CHUNK_W - 1) updateChunkMesh(cx + 1, cz);
-        if (lz == 0) updateChunkMesh(cx, cz - 1);
-        if (lz == CHUNK_W - 1) updateChunkMesh(cx, cz + 1);
+        // 降采样的区块：同 lod 邻居的 halo 来自贴边 s 层的降采样结果 (邻居也是降采样的，会整体重建)
+        int edge = 1 << chunk->lod;
+        if (lx < edge) markSliceDirty(cx - 1, cz, 0, CHUNK_W);
+        if (lx >= CHUNK_W - edge) markSliceDirty(cx + 1, cz, 0, 0);
+        if (lz < edge) markSliceDirty(cx, cz - 1, 2, CHUNK_W);
+        if (lz >= CHUNK_W - edge) markSliceDirty(cx, cz + 1, 2, 0);
     }
 }
 
-void World::updateChunkMesh(int cx, int cz) {
-    auto it = chunks.find({cx, cz});
-    if (it != chunks.end()) {
-        it->second->rebuild();
+void World::markDirty(int cx, int cz) {
+    Chunk* chunk = findChunk(cx, cz);
+    if (!chunk) return;
+    chunk->needsFullRebuild = true;
+    if (chunk->inDirtyQueue) return;
+    chunk->inDirtyQueue = true;
+    dirtyQueue.push_back({cx, cz});
+}
+
+void World::markSliceDirty(int cx, int cz, int axis, int plane) {
+    Chunk* chunk = findChunk(cx, cz);
+    if (!chunk) return;
+    chunk->dirtySlices.set(sliceIndex(axis, plane));
+    if (chunk->inDirtyQueue) return;
+    chunk->inDirtyQueue = true;
+    dirtyQueue.push_back({cx, cz});
+}
+
+void World::processDirtyChunks() {
+    for (const ChunkCoord& c : dirtyQueue) {
+        Chunk* chunk = findChunk(c.x, c.z);
+        if (!chunk) continue; // 排队期间已被卸载
+        chunk->inDirtyQueue = false;
+
+        // 增量路径：已有网格、且没有后台任务 (否则任务可能基于编辑前的快照，结果会盖掉增量修改)
+        uint64_t key = chunkKey(c.x, c.z);
+        // 降采样的区块每次都整体重建 (切面补丁是按原始精度生成的)
+        if (!chunk->needsFullRebuild && chunk->lod == 0 && chunk->hasMesh() && !meshJobs.busy(key)) {
+            rebuildSlices(c.x, c.z, *chunk);
+            continue;
+        }
+        chunk->needsFullRebuild = false;
+        chunk->dirtySlices.reset();
+        chunk->dirtySections.reset();
+        // 整体重建的结果包含所有编辑，尚未应用的切面补丁作废
+        chunk->slicePatches.clear();
+
+        // 同一区块的任务已在排队时 JobSystem 会合并；正在执行时只追加一次，执行时重新取快照
+        meshJobs.submit(key, meshPriority(c.x, c.z), [this, chunk, c, type = mesher] {
+            PROFILE_SCOPE("mesh chunk", "mesh");
+            ChunkSnapshot snap;
+            {
+                PROFILE_SCOPE("snapshot", "mesh");
+                buildSnapshot(c.x, c.z, snap);
+            }
+            ChunkMesh mesh;
+            // 连通性按原始方块计算，之后才降采样
+            for (int s = 0; s < SECTION_COUNT; ++s) mesh.visibility[s] = Chunk::computeVisibility(snap, s);
+            snap.applyLod();
+            chunk->buildMesh(snap, mesh, type);
+            chunk->publishMesh(std::move(mesh));
+        });
     }
+    dirtyQueue.clear();
+}
+
+void World::rebuildSlices(int cx, int cz, Chunk& chunk) {
+    PROFILE_SCOPE("rebuild slices");
+    // 主线程直接读取当前方块 (写入也只在主线程，无需加锁)，每个切面只读两层
+    const int dims[] = {CHUNK_W, CHUNK_H, CHUNK_W};
+    std::vector<BlockType> below, above;
+    int lastAxis = -1, lastPlane = -1;
+
+    // 取 axis 方向第 layer 层 (可为 -1 或 dims[axis]，即邻居的贴边层 / 世界外的空气；
+    // 降采样的邻居与 buildSnapshot 一致按空气处理)
+    auto fetchLayer = [&](int axis, int layer, std::vector<BlockType>& out) {
+        int u = (axis + 1) % 3;
+        int v = (axis + 2) % 3;
+        out.resize(dims[u] * dims[v]);
+        const Chunk* src = &chunk;
+        if (layer < 0 || layer >= dims[axis]) {
+            src = axis == 1 ? nullptr
+                : findChunk(cx + (axis == 0 ? (layer < 0 ? -1 : 1) : 0),
+                            cz + (axis == 2 ? (layer < 0 ? -1 : 1) : 0));
+            if (!src || src->lod != 0) { std::fill(out.begin(), out.end(), AIR); return; }
+            layer = layer < 0 ? dims[axis] - 1 : 0;
+        }
+        // 按行读取；一行落在单值段里时直接整段填充，不逐格解码
+        int x[3] = {0, 0, 0};
+        x[axis] = layer;
+        BlockType* dst = out.data();
+        for (x[v] = 0; x[v] < dims[v]; ++x[v], dst += dims[u]) {
+            for (int start = 0; start < dims[u]; start += (u == 1 ? SECTION_H : dims[u])) {
+                int len = u == 1 ? SECTION_H : dims[u];
+                x[u] = start;
+                const ChunkSection& sec = src->section(x[1]);
+                if (sec.isUniform()) { std::fill_n(dst + start, len, sec.uniformType()); continue; }
+                for (int i = 0; i < len; ++i) {
+                    x[u] = start + i;
+                    dst[start + i] = sec.get(x[0], x[1] % SECTION_H, x[2]);
+                }
+            }
+        }
+    };
+
+    for (int axis = 0; axis < 3; ++axis) {
+        for (int plane = 0; plane <= dims[axis]; ++plane) {
+            int s = sliceIndex(axis, plane);
+            if (!chunk.dirtySlices.test(s)) continue;
+
+            // 相邻切面共用一层 (编辑总是标记 plane 与 plane + 1)，上一个切面的 above 即这一个的 below
+            if (lastAxis == axis && lastPlane == plane - 1) std::swap(below, above);
+            else fetchLayer(axis, plane - 1, below);
+            fetchLayer(axis, plane, above);
+            lastAxis = axis;
+            lastPlane = plane;
+            // 半透明的面放进对应的半透明切面 (即使为空也要覆盖，清掉原来的水面)
+            SlicePatch patch{s, {}}, translucent{translucentSlice(s), {}};
+            chunk.buildSlice(axis, plane, below.data(), above.data(), patch.vertices);
+            moveTranslucentQuads(patch.vertices, translucent.vertices);
+            chunk.slicePatches.push_back(std::move(patch));
+            chunk.slicePatches.push_back(std::move(translucent));
+        }
+    }
+    chunk.dirtySlices.reset();
+
+    // 被编辑的段重算连通性 (只改了切面、没有方块变化的邻居区块不会有脏段)
+    for (int s = 0; s < SECTION_COUNT; ++s)
+        if (chunk.dirtySections.test(s)) chunk.setVisibility(s, chunk.computeVisibility(s));
+    chunk.dirtySections.reset();
+}
+
+void World::setMesher(MesherType type) {
+    if (type == mesher) return;
+    mesher = type;
+    for (auto& pair : chunks) markDirty(pair.first.x, pair.first.z);
+}
+
+float World::meshPriority(int cx, int cz) const {
+    // 区块中心到玩家的水平距离 (以区块为单位)
+    float dx = (cx + 0.5f) * CHUNK_W - focusPos.x;
+    float dz = (cz + 0.5f) * CHUNK_W - focusPos.z;
+    float dist2 = (dx * dx + dz * dz) / float(CHUNK_W * CHUNK_W);
+
+    // 视锥外的区块整体排在视锥内的之后
+    if (focusFrustum) {
+        const Chunk* chunk = findChunk(cx, cz);
+        if (chunk && !focusFrustum->isBoxVisible(chunk->aabb)) dist2 += 1e6f;
+    }
+    return dist2;
+}
+
+void World::updateFocus(const glm::vec3& playerPos, const Frustum& frustum) {
+    focusPos = playerPos;
+    focusFrustum = &frustum;
+    meshJobs.reprioritize([this](uint64_t key) {
+        return meshPriority((int)(uint32_t)(key >> 32), (int)(uint32_t)key);
+    });
 }
\ No newline at end of file
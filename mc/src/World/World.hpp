@@ -2,8 +2,18 @@
 #include <vector>
 #include <memory>
 #include <unordered_map>
+#include <unordered_set>
+#include <mutex>
+#include <shared_mutex>
+#include <functional>
 #include "Chunk.hpp"
 #include "../Math/PerlinNoise.hpp"
+#include "../Math/Frustum.hpp"
+#include "../Core/JobSystem.hpp"
+#include "RegionFile.hpp"
+#include "ChunkGrid.hpp"
+#include "ChunkBoundsIndex.hpp"
+#include "ChunkPool.hpp"
 
 // 哈希结构体保持在头文件，因为它是模板参数
 struct ChunkCoord {
@@ -11,23 +21,150 @@ struct ChunkCoord {
     bool operator==(const ChunkCoord& o) const { return x == o.x && z == o.z; }
 };
 struct ChunkHash {
-    std::size_t operator()(const ChunkCoord& c) const { return c.x ^ (c.z << 16); }
+    // 两个坐标拼成 64 位再乘法散列，负坐标与相邻坐标都能均匀分布
+    std::size_t operator()(const ChunkCoord& c) const {
+        uint64_t key = ((uint64_t)(uint32_t)c.x << 32) | (uint32_t)c.z;
+        return (std::size_t)((key * 0x9E3779B97F4A7C15ull) >> 16);
+    }
 };
 
 class World {
 public:
+    // 区块的所有权与遍历；按坐标查找走 findChunk (环形网格，冲突的少数区块才查哈希表)
     std::unordered_map<ChunkCoord, std::unique_ptr<Chunk>, ChunkHash> chunks;
 
+    // 按区块坐标查找，不存在返回 nullptr (主线程，或后台线程持有 chunkMutex 时调用)
+    Chunk* findChunk(int cx, int cz) const {
+        if (Chunk* c = grid.find(cx, cz)) return c;
+        if (overflowChunks == 0) return nullptr;
+        auto it = chunks.find({cx, cz});
+        return it != chunks.end() ? it->second.get() : nullptr;
+    }
+
     World(const PerlinNoise& noise);
+    ~World();
+
+    // 开启存档：区块先从 directory 下的区域文件读取，没有再生成；卸载时写回
+    void enablePersistence(const std::string& directory);
+    // 把所有被编辑过的区块交给后台线程写盘 (不阻塞)
+    void saveModifiedChunks();
+    size_t pendingSaves() const { return regionStore ? regionStore->pendingWrites() : 0; }
 
+    // 同步读取 / 生成并接入一个区块 (基准测试等不走流式加载的场合)
     void addChunk(int x, int z);
+    void removeChunk(int x, int z);
+    // 区块被卸载前回调 (渲染器借此归还 GPU 缓冲区间)
+    std::function<void(Chunk&)> onChunkRemoved;
+    // 视锥内的已加载区块追加到 out (主线程)
+    void cullChunks(const Frustum& frustum, std::vector<Chunk*>& out) const { boundsIndex.cull(frustum, out); }
+    const ChunkBoundsIndex& getBoundsIndex() const { return boundsIndex; }
     BlockType getBlock(int x, int y, int z);
+    // (x, y, z) 所在的段是否整段为空气；未加载的区块与世界高度之外也视为空 (射线与碰撞据此整段跳过)
+    bool isSectionEmpty(int x, int y, int z);
     void setBlock(int x, int y, int z, BlockType type);
 
+    // 每帧调用一次：把本帧标记为脏的区块各提交一次重建 (多次编辑合并为一次)；
+    // 只有个别切面变化、且没有后台任务在处理的区块直接在主线程重建这几个切面
+    void processDirtyChunks();
+    size_t dirtyChunkCount() const { return dirtyQueue.size(); }
+
+    // 切换网格算法，已加载的区块全部按新算法重建
+    void setMesher(MesherType type);
+    MesherType getMesher() const { return mesher; }
+
+    // 拷贝区块及其四个邻居的边界列到快照 (后台线程调用)；缺失的邻居按空气处理
+    void buildSnapshot(int cx, int cz, ChunkSnapshot& snap) const;
+
+    // 区块流式加载：以玩家为中心加载 renderDistance 半径内的区块，
+    // 超出 renderDistance + unloadMargin 的区块被卸载 (两者之间为滞回带，避免边界来回抖动)
+    // 流水线：后台线程由近到远读存档或生成地形 -> 下一次调用时在主线程接入 -> 网格任务 -> 渲染器上传
+    void updateStreaming(const glm::vec3& playerPos);
+    void setRenderDistance(int dist);
+    int getRenderDistance() const { return renderDistance; }
+    int unloadMargin = 2;
+    // 同时在后台读取 / 生成的区块数上限；其余留在按距离排好的加载队列里，中心移动后按新距离重排
+    int maxPendingLoads = 16;
+    // 每帧最多接入的区块数 (接入时本区块和邻居都要重建网格)；其余已完成的留到后面几帧，近的先接入
+    int maxIntegrationsPerFrame = 8;
+    size_t pendingLoads() const { return loading.size(); }
+    // 卸载的区块放回池中，加载时优先复用 (见 ChunkPool)；limit 为池中最多保留的区块数，0 关闭回收
+    void setChunkPoolLimit(size_t limit) { chunkPool.setHighWaterMark(limit); }
+    ChunkPool::Stats chunkPoolStats() const { return chunkPool.stats(); }
+    // 累计接入 / 卸载的区块数 (长时间运行测试据此算吞吐)
+    uint64_t loadedChunksTotal = 0;
+    uint64_t unloadedChunksTotal = 0;
+    // 以 pos 所在区块为中心、radius 半径 (圆形，同加载范围) 内的区块都已加载且网格已上传 (Chunk::meshUploaded)；
+    // 设置了视锥 (updateFocus) 时视锥外的区块只要求网格建好，渲染器只上传视锥内的
+    bool isAreaReady(const glm::vec3& pos, int radius) const;
+
+    // 远处区块的网格细节级别：距离 (区块) 达到 dist 起按 2 倍降采样，2 * dist 起 4 倍，4 * dist 起 8 倍；
+    // 0 关闭。改变后随下次 updateStreaming 生效
+    static constexpr int MAX_LOD = 3;
+    void setLodDistance(int dist);
+    int getLodDistance() const { return lodDistance; }
+
+    // 每帧更新玩家位置与视锥体，排队中的网格任务按 "视锥内优先 + 距离由近到远" 重排
+    void updateFocus(const glm::vec3& playerPos, const Frustum& frustum);
+    size_t pendingMeshJobs() const { return meshJobs.pending(); }
+
 private:
     const PerlinNoise& noiseGen;
-    void updateChunkMesh(int cx, int cz);
-    Chunk* lastAccessedChunk = nullptr;
-    int lastCX = -999999;
-    int lastCZ = -999999;
-};
\ No newline at end of file
+    std::unique_ptr<RegionStore> regionStore;
+    void saveChunk(const ChunkCoord& c, Chunk& chunk);
+    // 优先读存档，没有再生成地形 (任意线程)
+    std::unique_ptr<Chunk> loadOrGenerate(int x, int z);
+    ChunkPool chunkPool;
+    // 把已就绪的区块插入网格与哈希表并安排网格构建 (主线程)
+    void insertChunk(int x, int z, std::unique_ptr<Chunk> chunk);
+    // 主线程独占写 (区块增删、方块修改)，后台线程构建快照时共享读；主线程自己的读取无需加锁
+    mutable std::shared_mutex chunkMutex;
+    std::vector<ChunkCoord> dirtyQueue; // 等待重建网格的区块 (仅主线程访问)
+    MesherType mesher = MesherType::Binary;
+    void markDirty(int cx, int cz);
+    void markSliceDirty(int cx, int cz, int axis, int plane);
+    void markNeighborsDirty(int cx, int cz);
+    void rebuildSlices(int cx, int cz, Chunk& chunk);
+    float meshPriority(int cx, int cz) const;
+    static uint64_t chunkKey(int cx, int cz) { return ((uint64_t)(uint32_t)cx << 32) | (uint32_t)cz; }
+
+    // 环形网格按 renderDistance + unloadMargin 确定大小，加载范围内的区块各占一个槽
+    ChunkGrid grid;
+    size_t overflowChunks = 0; // 槽被占用而只在哈希表里的区块数
+    ChunkBoundsIndex boundsIndex; // 视锥剔除用的分组包围盒 (与 chunks 同步增删)
+    void resizeGrid();
+
+    // 流式加载状态
+    int renderDistance = 6;
+    int centerX = 0, centerZ = 0;
+    bool streamingDirty = true;           // 中心区块或半径变化后需要重建加载队列
+    std::vector<ChunkCoord> loadQueue;    // 待加载的区块，按距离由近到远
+    size_t loadCursor = 0;
+    void rebuildLoadQueue();
+    void evictFarChunks();
+    void submitLoads();
+    void integrateLoadedChunks();
+    bool inKeepRange(int cx, int cz) const;
+
+    // 后台加载：loading 为已提交、尚未接入的区块 (仅主线程)，完成的区块由后台线程放进 loaded，
+    // 主线程取到 integrating 里按每帧上限接入
+    std::unordered_set<uint64_t> loading;
+    std::mutex loadedMutex;
+    std::vector<std::pair<ChunkCoord, std::unique_ptr<Chunk>>> loaded, integrating;
+
+    int lodDistance = 8;
+    float chunkDistance(int cx, int cz) const; // 到中心区块的距离 (区块)
+    int lodFor(float dist) const;
+    void updateLods();
+
+    glm::vec3 focusPos{0.0f};
+    const Frustum* focusFrustum = nullptr;
+
+    // 卸载时网格任务还在执行的区块 (任务持有裸指针)，等任务结束再回收，主线程不等待 (仅主线程)
+    std::vector<std::pair<uint64_t, std::unique_ptr<Chunk>>> retiredChunks;
+    void reclaimRetiredChunks();
+
+    // 放在 chunks、loaded 之后：析构时先停掉线程池，再释放区块
+    // 加载与网格分两个线程池 (tag 都是区块坐标，同一个池里会被当成同一对象的任务合并)
+    JobSystem loadJobs{0, "load worker"};
+    JobSystem meshJobs{0, "mesh worker"};
+};
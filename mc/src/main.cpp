@@ -4,12 +4,20 @@
 #include <iostream>
 #include <fstream> // 文件流
 #include <sstream> // 字符串流
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <ctime>
 
 #include "World/World.hpp"
 #include "Physics/Player.hpp"
 #include "Math/Raycast.hpp"
 #include "Graphics/Shader.hpp"
 #include "Math/Frustum.hpp"
+#include "Graphics/ChunkRenderer.hpp"
+#include "World/CaveCuller.hpp"
+#include "Core/Profiler.hpp"
+#include "Graphics/GpuTimer.hpp"
 
 const int SCR_WIDTH = 1280;
 const int SCR_HEIGHT = 720;
@@ -21,6 +29,10 @@ float deltaTime = 0.0f, lastFrame = 0.0f;
 float lastX = SCR_WIDTH/2.0f, lastY = SCR_HEIGHT/2.0f;
 bool firstMouse = true;
 bool keys[1024] = {0};
+bool caveCulling = true;
+bool occlusionCulling = true;
+bool sortedPasses = true;
+int profileFrames = 120;
 
 std::string readFile(const char* path) {
     std::ifstream file;
@@ -39,6 +51,7 @@ std::string readFile(const char* path) {
 
 void mouse_button_callback(GLFWwindow* window, int button, int action, int mods) {
     if (action == GLFW_PRESS && globalWorld) {
+        PROFILE_SCOPE("block edit");
         RayHit hit = Raycaster::Cast(*globalWorld, player.camera.Pos, player.camera.Front, 8.0f);
         if (hit.hit) {
             if (button == GLFW_MOUSE_BUTTON_LEFT) {
@@ -59,6 +72,33 @@ void key_callback(GLFWwindow* window, int key, int scancode, int action, int mod
         else if (action == GLFW_RELEASE) keys[key] = false;
     }
     if (key == GLFW_KEY_G && action == GLFW_PRESS) player.toggleMode();
+    // M: 在两种网格算法之间切换 (输出相同，用于对比构建耗时)
+    if (key == GLFW_KEY_M && action == GLFW_PRESS && globalWorld) {
+        bool binary = globalWorld->getMesher() != MesherType::Binary;
+        globalWorld->setMesher(binary ? MesherType::Binary : MesherType::Greedy);
+        std::cout << "Mesher: " << (binary ? "binary" : "greedy") << std::endl;
+    }
+    // C: 开关洞穴剔除 (对比提交的区块数)
+    if (key == GLFW_KEY_C && action == GLFW_PRESS) {
+        caveCulling = !caveCulling;
+        std::cout << "Cave culling: " << (caveCulling ? "on" : "off") << std::endl;
+    }
+    // O: 开关 Hi-Z 遮挡剔除
+    if (key == GLFW_KEY_O && action == GLFW_PRESS) {
+        occlusionCulling = !occlusionCulling;
+        std::cout << "Occlusion culling: " << (occlusionCulling ? "on" : "off") << std::endl;
+    }
+    // P: 不透明 / 半透明分两遍排序绘制，还是单遍按提交顺序绘制 (对比片元着色器调用次数)
+    if (key == GLFW_KEY_P && action == GLFW_PRESS) {
+        sortedPasses = !sortedPasses;
+        std::cout << "Sorted passes: " << (sortedPasses ? "on" : "off") << std::endl;
+    }
+    // F9: 录制接下来 profileFrames 帧，写成 Chrome trace JSON
+    if (key == GLFW_KEY_F9 && action == GLFW_PRESS && !Profiler::get().isBusy()) {
+        std::string path = "profile-" + std::to_string((long long)time(nullptr)) + ".json";
+        Profiler::get().startCapture(profileFrames, path);
+        std::cout << "Profiling " << profileFrames << " frames..." << std::endl;
+    }
     if (action == GLFW_PRESS) {
         if(key == GLFW_KEY_1) player.selectedBlock = GRASS;
         if(key == GLFW_KEY_2) player.selectedBlock = DIRT;
@@ -74,7 +114,36 @@ void mouse_callback(GLFWwindow* window, double xpos, double ypos) {
     lastX = xpos; lastY = ypos;
 }
 
-int main() {
+int main(int argc, char** argv) {
+    // 启动耗时从进程开始算 (含创建窗口、编译着色器)
+    const auto startTime = std::chrono::steady_clock::now();
+    Profiler::get().setThreadName("main");
+    // 命令行参数：--render-distance N (区块半径，默认 6)，--mesher binary|greedy (默认 binary)，
+    // --lod N (从第 N 个区块起降低远处网格精度，默认 8，0 关闭)，--record-path 文件 (录制飞行路径，供 WorldSoak 回放)，
+    // --profile-frames N (按 F9 录制的帧数，默认 120)，--upload-budget KB (每帧上传新网格的字节预算，默认 1024)，
+    // --chunk-pool N (回收池最多保留的区块数，默认 128，0 关闭)
+    int renderDistance = 6;
+    int lodDistance = 8;
+    MesherType mesher = MesherType::Binary;
+    std::string recordPath;
+    int uploadBudgetKb = 1024;
+    int chunkPoolLimit = 128;
+    for (int i = 1; i + 1 < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--render-distance" || arg == "-r") renderDistance = std::max(1, std::atoi(argv[++i]));
+        else if (arg == "--lod") lodDistance = std::max(0, std::atoi(argv[++i]));
+        else if (arg == "--mesher") mesher = std::string(argv[++i]) == "greedy" ? MesherType::Greedy : MesherType::Binary;
+        else if (arg == "--record-path") recordPath = argv[++i];
+        else if (arg == "--profile-frames") profileFrames = std::max(1, std::atoi(argv[++i]));
+        else if (arg == "--upload-budget") uploadBudgetKb = std::max(1, std::atoi(argv[++i]));
+        else if (arg == "--chunk-pool") chunkPoolLimit = std::max(0, std::atoi(argv[++i]));
+    }
+    // 每 0.5 秒记录一个路点 "x y z"
+    std::ofstream pathRecorder;
+    if (!recordPath.empty()) pathRecorder.open(recordPath);
+    // 远裁剪面覆盖整个加载半径
+    const float farPlane = std::max(500.0f, (renderDistance + 2) * (float)CHUNK_W);
+
     glfwInit();
     glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 4);
     glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 5);
@@ -104,6 +173,8 @@ int main() {
     std::string lineFS = readFile("res/shaders/line.fs");
     std::string uiVS = readFile("res/shaders/ui.vs");
     std::string uiFS = readFile("res/shaders/ui.fs");
+    std::string hizReduceCS = readFile("res/shaders/hiz_reduce.cs");
+    std::string chunkCullCS = readFile("res/shaders/chunk_cull.cs");
 
     Shader blockShader(chunkVS.c_str(), chunkFS.c_str());
     Shader lineShader(lineVS.c_str(), lineFS.c_str());
@@ -113,12 +184,30 @@ int main() {
 
     PerlinNoise noise(123);
     World world(noise);
+    // 先用初始相机建立视锥体，让启动时的网格任务也按可见性排序
+    frustum.update(glm::perspective(glm::radians(60.0f), (float)SCR_WIDTH/SCR_HEIGHT, 0.1f, farPlane) * player.camera.GetViewMatrix());
+    world.updateFocus(player.camera.Pos, frustum);
     globalWorld = &world;
-    
-    int viewDist = 6;
-    for(int x=-viewDist; x<=viewDist; ++x) {
-        for(int z=-viewDist; z<=viewDist; ++z) world.addChunk(x, z);
-    }
+
+    // 存档目录：区块优先从区域文件读取，编辑过的区块定期在后台写盘
+    world.enablePersistence("saves/world");
+
+    // 区块随玩家移动流式生成/卸载，不再在启动时一次性生成
+    world.setRenderDistance(renderDistance);
+    world.setMesher(mesher);
+    world.setLodDistance(lodDistance);
+    world.setChunkPoolLimit(chunkPoolLimit);
+
+    // 所有区块共用一个顶点缓冲，一次间接绘制提交
+    ChunkRenderer chunkRenderer;
+    chunkRenderer.uploadBudget = (size_t)uploadBudgetKb * 1024;
+    world.onChunkRemoved = [&](Chunk& chunk) { chunkRenderer.release(chunk); };
+    CaveCuller caveCuller;
+    // 上一帧深度建成的 Hi-Z 金字塔，区块绘制前在 GPU 上剔除被挡住的区块
+    HiZCuller hiz(SCR_WIDTH, SCR_HEIGHT, hizReduceCS.c_str(), chunkCullCS.c_str());
+    std::vector<Chunk*> frustumChunks, visibleChunks;
+    GpuTimer gpuTimer;
+    chunkRenderer.gpuTimer = &gpuTimer;
 
     // --- UI 数据 ---
     // 1. 准星 (十字)
@@ -154,13 +243,26 @@ int main() {
     glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3*sizeof(float), (void*)0); glEnableVertexAttribArray(0);
 
     // 定义在 main 函数外或作为静态变量
-    char titleBuffer[256]; 
+    char titleBuffer[512]; 
 
     while (!glfwWindowShouldClose(window)) {
         float currentFrame = glfwGetTime();
         deltaTime = currentFrame - lastFrame;
         lastFrame = currentFrame;
 
+        // 性能分析：切换帧、回读上几帧的 GPU 计时；录制结束后几帧写出 trace
+        switch (Profiler::get().beginFrame()) {
+        case Profiler::FrameResult::TraceWritten:
+            std::cout << "Profile written to " << Profiler::get().tracePath() << std::endl;
+            break;
+        case Profiler::FrameResult::WriteFailed:
+            std::cerr << "Failed to write profile " << Profiler::get().tracePath() << std::endl;
+            break;
+        default:
+            break;
+        }
+        gpuTimer.beginFrame();
+
         // --- FPS 计算与标题显示 ---
         static float fpsTimer = 0.0f;
         static int frameCounter = 0;
@@ -169,7 +271,14 @@ int main() {
         if (fpsTimer >= 0.25f) {
             float fps = frameCounter / fpsTimer;
             float ms = 1000.0f / fps;
-            sprintf(titleBuffer, "MyCraft - FPS: %.1f (%.2f ms)", fps, ms);
+            std::string fragments = chunkRenderer.fragmentInvocations < 0 ? "n/a"
+                : std::to_string(chunkRenderer.fragmentInvocations / 1000) + "k";
+            sprintf(titleBuffer, "MyCraft - FPS: %.1f (%.2f ms) | chunks: %d / %d in frustum%s, occluded draws: %s, draw calls: %d, fragments: %s%s, upload: %zu KB (%d deferred)",
+                    fps, ms, chunkRenderer.drawnChunks, (int)frustumChunks.size(),
+                    caveCulling ? "" : " (cave culling off)",
+                    occlusionCulling ? std::to_string(chunkRenderer.occludedDraws).c_str() : "off",
+                    chunkRenderer.drawCalls, fragments.c_str(), sortedPasses ? "" : " (unsorted)",
+                    chunkRenderer.uploadedBytes / 1024, chunkRenderer.deferredMeshes);
             glfwSetWindowTitle(window, titleBuffer);
             
             fpsTimer = 0.0f;
@@ -178,30 +287,82 @@ int main() {
 
 
         bool inputs[6] = { keys[GLFW_KEY_W], keys[GLFW_KEY_S], keys[GLFW_KEY_A], keys[GLFW_KEY_D], keys[GLFW_KEY_SPACE], keys[GLFW_KEY_LEFT_CONTROL] };
-        player.update(deltaTime, world, inputs);
+        {
+            PROFILE_SCOPE("player update");
+            player.update(deltaTime, world, inputs);
+        }
+        {
+            PROFILE_SCOPE("streaming");
+            world.updateStreaming(player.position);
+        }
+        {
+            PROFILE_SCOPE("dirty chunks");
+            world.processDirtyChunks();
+        }
+
+        static float saveTimer = 0.0f;
+        saveTimer += deltaTime;
+        if (saveTimer >= 10.0f) {
+            PROFILE_SCOPE("save chunks");
+            world.saveModifiedChunks();
+            saveTimer = 0.0f;
+        }
+
+        static float recordTimer = 0.0f;
+        recordTimer += deltaTime;
+        if (pathRecorder.is_open() && recordTimer >= 0.5f) {
+            pathRecorder << player.position.x << ' ' << player.position.y << ' ' << player.position.z << '\n';
+            recordTimer = 0.0f;
+        }
 
         glClearColor(0.6f, 0.8f, 1.0f, 1.0f);
         glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
         blockShader.use();
-        glm::mat4 proj = glm::perspective(glm::radians(60.0f), (float)SCR_WIDTH/SCR_HEIGHT, 0.1f, 500.0f);
+        glm::mat4 proj = glm::perspective(glm::radians(60.0f), (float)SCR_WIDTH/SCR_HEIGHT, 0.1f, farPlane);
         glm::mat4 view = player.camera.GetViewMatrix();
         // 更新视锥体 
         frustum.update(proj * view);
+        world.updateFocus(player.camera.Pos, frustum);
 
         blockShader.setMat4("projection", proj);
         blockShader.setMat4("view", view);
-        for(auto& pair : world.chunks) {
-            if (!pair.second) continue; // 空指针检查
-
-            // 视锥体剔除 
-            if (!frustum.isBoxVisible(pair.second->aabb)) continue;
-            // TODO : 方块是否应该使用实例化绘制？ 等待验证完善
-            pair.second->update();
-            pair.second->render();
+        chunkRenderer.sortedPasses = sortedPasses;
+        chunkRenderer.beginFrame(player.camera.Pos);
+        // 视锥体剔除 (按 4x4 区块分组、批量测试)；先上传新网格 (连通性随网格一起更新)，再做洞穴剔除
+        frustumChunks.clear();
+        {
+            PROFILE_SCOPE("frustum cull");
+            world.cullChunks(frustum, frustumChunks);
+        }
+        {
+            PROFILE_SCOPE("chunk uploads");
+            chunkRenderer.uploadChunks(frustumChunks);
+        }
+        if (caveCulling) {
+            PROFILE_SCOPE("cave cull");
+            caveCuller.cull(world, player.camera.Pos, frustum, frustumChunks, visibleChunks);
+        }
+        {
+            PROFILE_SCOPE("draw submit");
+            for (Chunk* chunk : caveCulling ? visibleChunks : frustumChunks) chunkRenderer.addDraw(*chunk);
+            chunkRenderer.draw(occlusionCulling ? &hiz : nullptr);
+        }
+        // 只含区块的深度，供下一帧做遮挡测试
+        if (occlusionCulling) {
+            PROFILE_SCOPE("hi-z build");
+            GpuScope gpuScope(&gpuTimer, "hi-z build");
+            hiz.build(proj * view);
+        } else {
+            hiz.invalidate();
         }
 
-        RayHit hit = Raycaster::Cast(world, player.camera.Pos, player.camera.Front, 8.0f);
+        RayHit hit;
+        {
+            PROFILE_SCOPE("raycast");
+            hit = Raycaster::Cast(world, player.camera.Pos, player.camera.Front, 8.0f);
+        }
+        int overlayTimer = gpuTimer.begin("overlay"); // 选中框与界面
         if (hit.hit) {
             lineShader.use();
             lineShader.setMat4("projection", proj);
@@ -243,8 +404,26 @@ int main() {
         glDrawArrays(GL_TRIANGLES, 0, 6);
 
         glEnable(GL_DEPTH_TEST);
+        gpuTimer.end(overlayTimer);
+
+        {
+            PROFILE_SCOPE("swap buffers");
+            glfwSwapBuffers(window);
+        }
 
-        glfwSwapBuffers(window);
+        // 启动指标：玩家周围 (半径 1) 的区块第一次能画出来、整个加载范围都就绪的时刻
+        static bool firstFrameLogged = false, fullViewLogged = false;
+        if (!fullViewLogged) {
+            double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime).count();
+            if (!firstFrameLogged && world.isAreaReady(player.position, 1)) {
+                firstFrameLogged = true;
+                std::cout << "Time to first frame: " << ms << " ms" << std::endl;
+            }
+            if (firstFrameLogged && world.isAreaReady(player.position, renderDistance)) {
+                fullViewLogged = true;
+                std::cout << "Time to full view: " << ms << " ms (" << world.chunks.size() << " chunks)" << std::endl;
+            }
+        }
         glfwPollEvents();
     }
 